@@ -23,46 +23,1347 @@ work in progress
 */
 #include <iostream>
 #include <vector>
+#include <cmath>
+#include <cstdint>
+#include <cassert>
+#include <chrono>
+#include <string>
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <numeric>
+#include <limits>
+#include <iterator>
+#include <cstring>
+#include <fstream>
+#include <filesystem>
+#include <stdexcept>
+#include <random>
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+#if __has_include(<version>)
+#include <version>
+#endif
+#if defined(__cpp_lib_ranges)
+#include <ranges>
+#endif
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+#if defined(_WIN32)
+#include <process.h>
+#endif
 
+// Mod-30 wheel layout: byte i of the table covers 30 * i .. 30 * i + 29, and its 8 bits
+// are the residues coprime to 2 * 3 * 5, so 30 integers take 8 bits instead of 30.
+// Bits live in raw 64-bit words and a set bit means prime.
 struct Sieve_struct {
+    static constexpr uint8_t WHEEL_RESIDUES[8] = {1, 7, 11, 13, 17, 19, 23, 29};
+    // residue mod 30 -> bit inside its byte, 8 for numbers sharing a factor with 30
+    static constexpr uint8_t WHEEL_INDEX[30] = {
+        8, 0, 8, 8, 8, 8, 8, 1, 8, 8, 8, 2, 8, 3, 8, 8, 8, 4, 8, 5, 8, 8, 8, 6, 8, 8, 8, 8, 8, 7
+    };
+
     size_t limit;
-    std::vector<bool> primes;
+    std::vector<uint64_t> words;
+
+    // Global bit index of a number coprime to 30
+    static size_t bit_of(size_t n) { return 8 * (n / 30) + WHEEL_INDEX[n % 30]; }
+    // Number stored at a global bit index
+    static size_t value_of(size_t bit) { return 30 * (bit / 8) + WHEEL_RESIDUES[bit % 8]; }
+
+    bool is_prime(size_t n) const { return is_prime(words.data(), limit, n); }
+
+    // Lookup shared by every holder of a wheel table, owned or memory-mapped
+    static bool is_prime(const uint64_t* words, size_t limit, size_t n) {
+        if (n > limit) return false;
+        if (n == 2 || n == 3 || n == 5) return true;
+        if (WHEEL_INDEX[n % 30] == 8) return false;
+        size_t bit = bit_of(n);
+        return (words[bit / 64] >> (bit % 64)) & 1;
+    }
 };
 
 class Sieve {
     public:
+    static constexpr size_t BLOCK_BYTES = 1 << 18; // wheel bytes crossed off together, 7.8M integers
+
+    // Floor of the square root, exact for the whole size_t range
+    static size_t isqrt(size_t n) {
+        size_t root = static_cast<size_t>(std::sqrt(static_cast<double>(n)));
+        while (root > 0 && root > n / root) root--;
+        while ((root + 1) <= n / (root + 1)) root++;
+        return root;
+    }
+
     static Sieve_struct initialize(size_t limit) {
-        std::vector<bool> primes = std::vector<bool>(limit + 1, true);
+        Sieve_struct sieve{limit, std::vector<uint64_t>(word_count(limit))};
+        sieve_bytes(sieve.words, 0, limit);
+        return sieve;
+    }
+
+    // Grows a table to new_limit, sieving only the wheel bytes it did not fully cover yet
+    static void extend(Sieve_struct& sieve, size_t new_limit) {
+        if (new_limit <= sieve.limit) return;
+        sieve.words.resize(word_count(new_limit));
+        sieve_bytes(sieve.words, sieve.limit / 30, new_limit);
+        sieve.limit = new_limit;
+    }
+
+    // Words needed for a wheel table reaching limit
+    static size_t word_count(size_t limit) {
+        return (limit / 30 + 8) / 8;
+    }
+
+    static std::vector<size_t> get_primes(const Sieve_struct& sieve) {
+        return get_primes(sieve, 0, sieve.limit);
+    }
+
+    // Primes in [low, high]; the output is reserved from a pi(x) estimate up front
+    // and filled by decoding each word's set bits with count-trailing-zeros
+    static std::vector<size_t> get_primes(const Sieve_struct& sieve, size_t low, size_t high) {
+        std::vector<size_t> prime_nums;
+        high = std::min(high, sieve.limit);
+        if (low > high) return prime_nums;
+        prime_nums.reserve(prime_count_estimate(high) - (low > 0 ? prime_count_lower_bound(low - 1) : 0));
+        for_each_prime(sieve, low, high, [&](size_t prime) { prime_nums.push_back(prime); });
+        return prime_nums;
+    }
+
+    // Calls callback(prime) for every prime in [low, high], in increasing order
+    template <typename Callback>
+    static void for_each_prime(const Sieve_struct& sieve, size_t low, size_t high, Callback callback) {
+        high = std::min(high, sieve.limit);
+        if (low > high) return;
+        for (size_t small : {2, 3, 5}) {
+            if (low <= small && small <= high) callback(small);
+        }
+
+        size_t first = first_bit_at_least(low), end = first_bit_above(high);
+        for (size_t word = first / 64; word < sieve.words.size() && word * 64 < end; word++) {
+            uint64_t bits = sieve.words[word] & range_mask(word, first, end);
+            while (bits) {
+                callback(Sieve_struct::value_of(word * 64 + ctz64(bits)));
+                bits &= bits - 1;
+            }
+        }
+    }
 
-        if (limit >= 1) {
-            primes[0] = false;
-            primes[1] = false;
+    // pi(high) - pi(low - 1) from popcounts over the wheel bits, no decoding involved
+    static size_t count_primes(const Sieve_struct& sieve, size_t low, size_t high) {
+        high = std::min(high, sieve.limit);
+        if (low > high) return 0;
+        size_t count = 0;
+        for (size_t small : {2, 3, 5}) {
+            if (low <= small && small <= high) count++;
         }
 
-        int sqrt_limit = sqrt(limit);
-        for (int i = 2; i <= sqrt_limit; i++) {
-            if (primes[i]) {
-                for (int j = i * i; j <= limit; j += i) {
-                    primes[j] = false;
+        size_t first = first_bit_at_least(low), end = first_bit_above(high);
+        if (end <= first) return count;
+        size_t first_word = first / 64, last_word = (end - 1) / 64;
+        if (first_word == last_word) {
+            return count + popcount64(sieve.words[first_word] & range_mask(first_word, first, end));
+        }
+        count += popcount64(sieve.words[first_word] & range_mask(first_word, first, end));
+        count += popcount_words(sieve.words.data() + first_word + 1, last_word - first_word - 1);
+        count += popcount64(sieve.words[last_word] & range_mask(last_word, first, end));
+        return count;
+    }
+
+    // Upper bound on pi(x) (Rosser & Schoenfeld / Dusart), good for sizing outputs
+    static size_t prime_count_estimate(size_t x) {
+        if (x < 60184) return x < 2 ? 0 : x / 2 + 1;
+        double lx = std::log(static_cast<double>(x));
+        return static_cast<size_t>(static_cast<double>(x) / (lx - 1.1)) + 1;
+    }
+
+    // Lower bound on pi(x), valid from x = 17 on
+    static size_t prime_count_lower_bound(size_t x) {
+        if (x < 17) return 0;
+        return static_cast<size_t>(static_cast<double>(x) / std::log(static_cast<double>(x)));
+    }
+
+    static int popcount64(uint64_t x) {
+#if defined(_MSC_VER)
+        return static_cast<int>(__popcnt64(x));
+#else
+        return __builtin_popcountll(x);
+#endif
+    }
+
+    static int ctz64(uint64_t x) {
+#if defined(_MSC_VER)
+        unsigned long index;
+        _BitScanForward64(&index, x);
+        return static_cast<int>(index);
+#else
+        return __builtin_ctzll(x);
+#endif
+    }
+
+    // Total set bits in count words; uses the AVX2 nibble-lookup popcount when available
+    static size_t popcount_words(const uint64_t* words, size_t count) {
+        size_t total = 0;
+        size_t i = 0;
+#if defined(__AVX2__)
+        const __m256i lookup = _mm256_setr_epi8(0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4,
+                                                0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4);
+        const __m256i low_nibbles = _mm256_set1_epi8(0x0F);
+        __m256i sums = _mm256_setzero_si256();
+        for (; i + 4 <= count; i += 4) {
+            __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(words + i));
+            __m256i lo = _mm256_shuffle_epi8(lookup, _mm256_and_si256(v, low_nibbles));
+            __m256i hi = _mm256_shuffle_epi8(lookup, _mm256_and_si256(_mm256_srli_epi16(v, 4), low_nibbles));
+            sums = _mm256_add_epi64(sums, _mm256_sad_epu8(_mm256_add_epi8(lo, hi), _mm256_setzero_si256()));
+        }
+        alignas(32) uint64_t lanes[4];
+        _mm256_store_si256(reinterpret_cast<__m256i*>(lanes), sums);
+        total = lanes[0] + lanes[1] + lanes[2] + lanes[3];
+#endif
+        for (; i < count; i++) {
+            total += popcount64(words[i]);
+        }
+        return total;
+    }
+
+    // Resets wheel bytes [byte_lo, byte_hi) to "prime" except for multiples of 7, 11 and 13,
+    // which come from a precomputed 7 * 11 * 13 = 1001 byte pattern instead of being crossed off.
+    static void fill_wheel(std::vector<uint64_t>& words, size_t byte_lo, size_t byte_hi) {
+        static const std::vector<uint8_t> pattern = [] {
+            std::vector<uint8_t> bytes(7 * 11 * 13);
+            for (size_t i = 0; i < bytes.size(); i++) {
+                for (int bit = 0; bit < 8; bit++) {
+                    size_t n = 30 * i + Sieve_struct::WHEEL_RESIDUES[bit];
+                    if (n % 7 != 0 && n % 11 != 0 && n % 13 != 0) {
+                        bytes[i] |= static_cast<uint8_t>(1u << bit);
+                    }
                 }
             }
+            return bytes;
+        }();
+
+        for (size_t byte = byte_lo; byte < byte_hi; byte++) {
+            uint64_t& word = words[byte / 8];
+            int shift = static_cast<int>(byte % 8) * 8;
+            word = (word & ~(uint64_t{0xFF} << shift)) | (uint64_t{pattern[byte % pattern.size()]} << shift);
+        }
+
+        if (byte_lo == 0 && byte_hi > 0) {
+            words[0] &= ~uint64_t{1};     // 1 is not prime
+            words[0] |= uint64_t{0b1110}; // 7, 11 and 13 are
+        }
+    }
+
+    // Crosses off the multiples p * q (q >= p, q coprime to 30) that fall in wheel bytes
+    // [byte_lo, byte_hi). Each of the 8 residues of q gives one fixed bit that repeats
+    // every p bytes, so the inner loop is a single strided bit clear.
+    static void cross_off(std::vector<uint64_t>& words, size_t p, size_t byte_lo, size_t byte_hi) {
+        for (uint8_t residue : Sieve_struct::WHEEL_RESIDUES) {
+            size_t q = p + (residue + 30 - p % 30) % 30;
+            size_t multiple = p * q;
+            size_t byte = multiple / 30;
+            if (byte < byte_lo) {
+                byte += (byte_lo - byte + p - 1) / p * p;
+            }
+            size_t bit = 8 * byte + Sieve_struct::WHEEL_INDEX[multiple % 30];
+            for (size_t end = 8 * byte_hi, stride = 8 * p; bit < end; bit += stride) {
+                words[bit / 64] &= ~(uint64_t{1} << (bit % 64));
+            }
         }
+    }
 
-        return Sieve_struct{limit, primes}; 
+    // First wheel bit whose number is >= n
+    static size_t first_bit_at_least(size_t n) {
+        size_t bit = 8 * (n / 30);
+        for (uint8_t residue : Sieve_struct::WHEEL_RESIDUES) {
+            if (residue >= n % 30) break;
+            bit++;
+        }
+        return bit;
     }
 
-    static std::vector<size_t> get_primes(const Sieve_struct& sieve) {
+    // First wheel bit whose number is > n
+    static size_t first_bit_above(size_t n) {
+        size_t bit = 8 * (n / 30);
+        for (uint8_t residue : Sieve_struct::WHEEL_RESIDUES) {
+            if (residue > n % 30) break;
+            bit++;
+        }
+        return bit;
+    }
+
+    // Mask of the bits of word that fall inside [first, end)
+    static uint64_t range_mask(size_t word, size_t first, size_t end) {
+        uint64_t mask = ~uint64_t{0};
+        if (first > word * 64) mask &= ~uint64_t{0} << (first - word * 64);
+        if (end < word * 64 + 64) mask &= (uint64_t{1} << (end - word * 64)) - 1;
+        return mask;
+    }
+
+    // Sieves wheel bytes [byte_lo, limit / 30] from scratch and clears the bits above limit
+    static void sieve_bytes(std::vector<uint64_t>& words, size_t byte_lo, size_t limit) {
+        size_t bytes = limit / 30 + 1;
+
+        std::vector<size_t> base_primes;
+        size_t sqrt_limit = isqrt(limit);
+        if (sqrt_limit >= 17) {
+            Sieve_struct base = initialize(sqrt_limit);
+            for (size_t p = 17; p <= sqrt_limit; p += 2) {
+                if (base.is_prime(p)) base_primes.push_back(p);
+            }
+        }
+
+        // Cross off one cache-sized block at a time instead of striding the whole table per prime
+        for (size_t block_lo = byte_lo; block_lo < bytes; block_lo += BLOCK_BYTES) {
+            size_t block_hi = std::min(bytes, block_lo + BLOCK_BYTES);
+            fill_wheel(words, block_lo, block_hi);
+            for (size_t p : base_primes) {
+                if (p * p >= 30 * block_hi) break;
+                cross_off(words, p, block_lo, block_hi);
+            }
+        }
+
+        clear_above(words, limit);
+    }
+
+    // Clears every bit that stands for a number above limit
+    static void clear_above(std::vector<uint64_t>& words, size_t limit) {
+        for (size_t bit = Sieve_struct::bit_of(limit / 30 * 30 + 1); bit < words.size() * 64; bit++) {
+            if (Sieve_struct::value_of(bit) > limit) {
+                words[bit / 64] &= ~(uint64_t{1} << (bit % 64));
+            }
+        }
+    }
+};
+
+// One cache-sized segment of odd numbers plus the next multiple of every base prime.
+// Sieving the segment right after the previous one reuses those offsets,
+// any other jump recomputes them with one division per base prime.
+struct Segment_struct {
+    uint64_t low = 0;                    // first number in the segment, always odd
+    uint64_t high = 0;                   // last number in the segment (inclusive)
+    std::vector<uint8_t> composite;      // composite[i] describes low + 2 * i
+    std::vector<uint64_t> next_multiple; // per base prime, first odd multiple not yet crossed off
+    bool valid = false;
+};
+
+// Sieves an arbitrary [low, high] window one segment at a time.
+// Only the base primes up to sqrt(high) and a single segment are kept in memory,
+// so the footprint is O(sqrt(high) + segment) however wide or far out the window is.
+class SegmentedSieve {
+    public:
+    static constexpr size_t DEFAULT_SEGMENT_BYTES = 1 << 18; // one byte per odd number, sized for L2
+
+    SegmentedSieve(uint64_t low, uint64_t high, size_t segment_bytes = DEFAULT_SEGMENT_BYTES)
+        : low(low), high(high), segment_bytes(std::max<size_t>(segment_bytes, 64)),
+          base_primes(base_primes_up_to(Sieve::isqrt(high))) {}
+
+    // Odd primes up to limit, the only ones that ever need crossing off in a segment
+    static std::vector<uint32_t> base_primes_up_to(size_t limit) {
+        Sieve_struct sieve = Sieve::initialize(limit);
+        std::vector<uint32_t> base;
+        for (size_t i = 3; i <= limit; i += 2) {
+            if (sieve.is_prime(i)) {
+                base.push_back(static_cast<uint32_t>(i));
+            }
+        }
+        return base;
+    }
+
+    // Crosses off the odd numbers of [seg_low, seg_high], seg_low must be odd
+    static void sieve_segment(Segment_struct& segment, uint64_t seg_low, uint64_t seg_high,
+                              const std::vector<uint32_t>& base_primes) {
+        bool contiguous = segment.valid && seg_low == segment.high + 1;
+        size_t known = contiguous ? segment.next_multiple.size() : 0;
+
+        size_t size = static_cast<size_t>((seg_high - seg_low) / 2 + 1);
+        segment.low = seg_low;
+        segment.high = seg_high;
+        segment.composite.assign(size, 0);
+        segment.next_multiple.resize(base_primes.size());
+        segment.valid = true;
+
+        if (seg_low == 1) {
+            segment.composite[0] = 1;
+        }
+
+        // Offsets from seg_low, so nothing wraps for a segment that ends at 2^64 - 1
+        for (size_t i = known; i < base_primes.size(); i++) {
+            uint64_t p = base_primes[i];
+            uint64_t offset;
+            if (p * p >= seg_low) {
+                offset = p * p - seg_low; // both odd, so the offset is even
+            } else {
+                offset = (p - seg_low % p) % p;
+                if (offset % 2 != 0) offset += p;
+            }
+            segment.next_multiple[i] = saturating_add(seg_low, offset);
+        }
+
+        for (size_t i = 0; i < base_primes.size(); i++) {
+            uint64_t p = base_primes[i];
+            uint64_t multiple = segment.next_multiple[i];
+            if (multiple > seg_high) continue;
+
+            size_t j = static_cast<size_t>((multiple - seg_low) / 2);
+            for (; j < size; j += p) {
+                segment.composite[j] = 1;
+            }
+            segment.next_multiple[i] = saturating_add(seg_low, 2 * static_cast<uint64_t>(j));
+        }
+    }
+
+    // A multiple past 2^64 - 1 is stored as 2^64 - 1, which is composite, so crossing it off is harmless
+    static uint64_t saturating_add(uint64_t value, uint64_t offset) {
+        return offset > std::numeric_limits<uint64_t>::max() - value ? std::numeric_limits<uint64_t>::max() : value + offset;
+    }
+
+    // Number of segments covering [low, high]
+    size_t segment_count() const {
+        uint64_t first = std::max<uint64_t>(low, 1) | 1;
+        if (first > high) return 0;
+        return static_cast<size_t>((high - first) / span() + 1);
+    }
+
+    // Sieves segment number index into segment, reusing its offsets when index follows the last one
+    void sieve(Segment_struct& segment, size_t index) const {
+        uint64_t seg_low = (std::max<uint64_t>(low, 1) | 1) + index * span();
+        uint64_t seg_high = high - seg_low < span() ? high : seg_low + span() - 1;
+        sieve_segment(segment, seg_low, seg_high, base_primes);
+    }
+
+    // Calls callback(segment) for every sieved segment of [low, high], in increasing order.
+    // The number 2 is never part of a segment since only odd numbers are stored.
+    template <typename Callback>
+    void for_each_segment(Callback callback) const {
+        Segment_struct segment;
+        size_t segments = segment_count();
+        for (size_t index = 0; index < segments; index++) {
+            sieve(segment, index);
+            callback(static_cast<const Segment_struct&>(segment));
+        }
+    }
+
+    // Calls callback(prime) for every prime in [low, high], in increasing order
+    template <typename Callback>
+    void for_each_prime(Callback callback) const {
+        if (low <= 2 && 2 <= high) {
+            callback(uint64_t{2});
+        }
+        for_each_segment([&](const Segment_struct& segment) {
+            for (size_t i = 0; i < segment.composite.size(); i++) {
+                if (!segment.composite[i]) {
+                    callback(segment.low + 2 * static_cast<uint64_t>(i));
+                }
+            }
+        });
+    }
+
+    std::vector<size_t> get_primes() const {
         std::vector<size_t> prime_nums;
-        for (size_t i = 0; i < sieve.limit; i++) {
-            if (sieve.primes[i]) {
-                prime_nums.push_back(i);
+        for_each_prime([&](uint64_t prime) { prime_nums.push_back(static_cast<size_t>(prime)); });
+        return prime_nums;
+    }
+
+    size_t count_primes() const {
+        size_t count = (low <= 2 && 2 <= high) ? 1 : 0;
+        for_each_segment([&](const Segment_struct& segment) {
+            count += std::count(segment.composite.begin(), segment.composite.end(), 0);
+        });
+        return count;
+    }
+
+    bool contains_two() const { return low <= 2 && 2 <= high; }
+
+    private:
+    uint64_t low;
+    uint64_t high;
+    size_t segment_bytes;
+    std::vector<uint32_t> base_primes;
+
+    uint64_t span() const { return 2 * static_cast<uint64_t>(segment_bytes); }
+};
+
+// Runs a SegmentedSieve on a pool of threads. Segments are handed out one at a time
+// through an atomic counter, and every worker keeps its own segment buffer and
+// base prime offsets, so the workers never share a writable cache line.
+// Results are stored per segment index, which keeps the merge in order.
+class ParallelSieve {
+    public:
+    ParallelSieve(uint64_t low, uint64_t high, unsigned threads = std::thread::hardware_concurrency(),
+                  size_t segment_bytes = SegmentedSieve::DEFAULT_SEGMENT_BYTES)
+        : sieve(low, high, segment_bytes), threads(std::max(threads, 1u)) {}
+
+    // Primes in [low, high], in increasing order
+    std::vector<size_t> get_primes() const {
+        std::vector<std::vector<size_t>> per_segment(sieve.segment_count());
+        run([&](size_t index, const Segment_struct& segment) {
+            std::vector<size_t>& out = per_segment[index];
+            for (size_t i = 0; i < segment.composite.size(); i++) {
+                if (!segment.composite[i]) {
+                    out.push_back(static_cast<size_t>(segment.low + 2 * static_cast<uint64_t>(i)));
+                }
             }
+        });
+
+        size_t total = sieve.contains_two() ? 1 : 0;
+        for (const auto& primes : per_segment) total += primes.size();
+
+        std::vector<size_t> prime_nums;
+        prime_nums.reserve(total);
+        if (sieve.contains_two()) prime_nums.push_back(2);
+        for (const auto& primes : per_segment) {
+            prime_nums.insert(prime_nums.end(), primes.begin(), primes.end());
         }
         return prime_nums;
     }
+
+    // Number of odd primes in every segment, in segment order (2 is not counted)
+    std::vector<size_t> segment_counts() const {
+        std::vector<size_t> counts(sieve.segment_count());
+        run([&](size_t index, const Segment_struct& segment) {
+            counts[index] = std::count(segment.composite.begin(), segment.composite.end(), 0);
+        });
+        return counts;
+    }
+
+    size_t count_primes() const {
+        std::vector<size_t> counts = segment_counts();
+        return std::accumulate(counts.begin(), counts.end(), size_t{sieve.contains_two() ? 1u : 0u});
+    }
+
+    private:
+    SegmentedSieve sieve;
+    unsigned threads;
+
+    // Calls callback(index, segment) from the workers, every segment exactly once
+    template <typename Callback>
+    void run(Callback callback) const {
+        size_t segments = sieve.segment_count();
+        std::atomic<size_t> next_segment{0};
+
+        auto worker = [&]() {
+            Segment_struct segment;
+            for (size_t index = next_segment++; index < segments; index = next_segment++) {
+                sieve.sieve(segment, index);
+                callback(index, static_cast<const Segment_struct&>(segment));
+            }
+        };
+
+        unsigned workers = static_cast<unsigned>(std::min<size_t>(threads, segments));
+        std::vector<std::thread> pool;
+        for (unsigned i = 1; i < workers; i++) {
+            pool.emplace_back(worker);
+        }
+        worker();
+        for (auto& thread : pool) {
+            thread.join();
+        }
+    }
 };
 
-int main() {
+// Lazily sieved primes in [low, high], usable directly in a range-based for loop.
+// The next segment is only sieved once iteration reaches it, and the base primes grow
+// on demand with sqrt of the current position, so starting is instant and memory stays
+// at one small segment plus O(sqrt(current)) however far the caller walks.
+// Iteration is single pass: every iterator obtained from begin() shares the range's cursor.
+class PrimeRange {
+    public:
+    static constexpr size_t DEFAULT_SEGMENT_BYTES = 1 << 15; // one byte per odd number, sized for L1
+
+    struct sentinel {};
+
+    class iterator {
+        public:
+        using iterator_category = std::input_iterator_tag;
+        using value_type = uint64_t;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const uint64_t*;
+        using reference = const uint64_t&;
+
+        iterator() = default;
+        explicit iterator(PrimeRange* range) : range(range) {}
+
+        reference operator*() const { return range->current; }
+        iterator& operator++() { range->advance(); return *this; }
+        void operator++(int) { range->advance(); }
+
+        bool operator==(sentinel) const { return range->done; }
+        bool operator!=(sentinel) const { return !range->done; }
+
+        private:
+        PrimeRange* range = nullptr;
+    };
+
+    explicit PrimeRange(uint64_t low, uint64_t high = std::numeric_limits<uint64_t>::max(),
+                        size_t segment_bytes = DEFAULT_SEGMENT_BYTES)
+        : low(low), high(high), segment_bytes(std::max<size_t>(segment_bytes, 64)) {}
+
+    // Not copyable: iterators point back into the range
+    PrimeRange(const PrimeRange&) = delete;
+    PrimeRange& operator=(const PrimeRange&) = delete;
+
+    iterator begin() {
+        if (!started) {
+            started = true;
+            if (low <= 2 && 2 <= high) {
+                current = 2;
+            } else {
+                advance();
+            }
+        }
+        return iterator(this);
+    }
+
+    sentinel end() const { return {}; }
+
+    private:
+    uint64_t low;
+    uint64_t high;
+    size_t segment_bytes;
+    std::vector<uint32_t> base_primes;
+    uint64_t base_limit = 0;
+    Segment_struct segment;
+    size_t position = 0;
+    uint64_t current = 0;
+    bool started = false;
+    bool done = false;
+
+    // Moves current to the next prime, sieving another segment when this one runs out
+    void advance() {
+        while (!done) {
+            for (; position < segment.composite.size(); position++) {
+                if (!segment.composite[position]) {
+                    current = segment.low + 2 * static_cast<uint64_t>(position++);
+                    return;
+                }
+            }
+            next_segment();
+        }
+    }
+
+    void next_segment() {
+        uint64_t span = 2 * static_cast<uint64_t>(segment_bytes);
+        uint64_t seg_low = segment.valid ? segment.high + 1 : std::max<uint64_t>(low, 3) | 1;
+        if (seg_low > high || (segment.valid && segment.high == high)) {
+            done = true;
+            return;
+        }
+        uint64_t seg_high = high - seg_low < span ? high : seg_low + span - 1;
+
+        if (base_limit < Sieve::isqrt(seg_high)) {
+            extend_base_primes(Sieve::isqrt(seg_high));
+        }
+
+        SegmentedSieve::sieve_segment(segment, seg_low, seg_high, base_primes);
+        position = 0;
+    }
+
+    // Base primes only need to reach sqrt(seg_high). They grow in chunks of a sixteenth (at
+    // least 4096) so a long walk rarely comes back here, but never past sqrt(high), which also
+    // keeps them within 32 bits. Once the list covers the square root of the new limit, only
+    // the added stretch is sieved, by the primes already known. Existing offsets stay valid
+    // because a longer base prime list keeps the same prefix.
+    void extend_base_primes(uint64_t needed) {
+        uint64_t chunk = std::max<uint64_t>(base_limit / 16, 4096);
+        uint64_t limit = std::min<uint64_t>({std::max(needed, base_limit + chunk), Sieve::isqrt(high),
+                                             std::numeric_limits<uint32_t>::max()});
+        if (base_limit < Sieve::isqrt(limit)) {
+            base_primes = SegmentedSieve::base_primes_up_to(limit);
+        } else {
+            std::vector<uint32_t> added;
+            Segment_struct stretch;
+            uint64_t span = 2 * static_cast<uint64_t>(segment_bytes);
+            for (uint64_t from = (base_limit + 1) | 1; from <= limit; from += span) {
+                SegmentedSieve::sieve_segment(stretch, from, std::min(limit, from + span - 1), base_primes);
+                for (size_t i = 0; i < stretch.composite.size(); i++) {
+                    if (!stretch.composite[i]) added.push_back(static_cast<uint32_t>(from + 2 * i));
+                }
+            }
+            base_primes.insert(base_primes.end(), added.begin(), added.end());
+        }
+        base_limit = limit;
+    }
+};
+
+// Every prime >= low, in increasing order, sieved as the caller walks
+inline PrimeRange primes_from(uint64_t low) {
+    return PrimeRange(low);
+}
+
+#if defined(__cpp_lib_ranges)
+static_assert(std::ranges::input_range<PrimeRange>, "PrimeRange should work with C++20 range adaptors");
+#endif
+
+// On-disk sieve cache: this header followed by the Sieve_struct wheel words in native byte order
+struct Sieve_cache_header {
+    char magic[8];       // "SIEVE30"
+    uint32_t version;    // SieveCache::VERSION, a byte-swapped value also means "other endianness"
+    uint32_t wheel;      // modulus of the body layout, always 30
+    uint64_t limit;
+    uint64_t word_count;
+    uint64_t checksum;   // FNV-1a over the body words
+};
+
+// A wheel table shared between processes through a read-only memory mapping of a cache file.
+// Opening a file that already reaches the requested limit costs one mmap call; the pages are
+// shared through the page cache and is_prime(n) reads straight from them. Asking for a larger
+// limit extends the existing table instead of sieving from zero and atomically replaces the file.
+class SieveCache {
+    public:
+    static constexpr uint32_t VERSION = 1;
+
+    static SieveCache open(const std::string& path, size_t limit) {
+        SieveCache cache;
+        if (cache.map(path) && cache.header->limit >= limit) {
+            return cache;
+        }
+
+        Sieve_struct table;
+        if (cache.header && cache.verify()) {
+            table.limit = cache.header->limit;
+            table.words.assign(cache.words, cache.words + cache.header->word_count);
+            Sieve::extend(table, limit);
+        } else {
+            table = Sieve::initialize(limit);
+        }
+        cache.unmap();
+
+        write(path, table);
+        if (!cache.map(path)) {
+            throw std::runtime_error("cannot map sieve cache " + path);
+        }
+        return cache;
+    }
+
+    SieveCache(SieveCache&& other) noexcept { *this = std::move(other); }
+    SieveCache& operator=(SieveCache&& other) noexcept {
+        if (this != &other) {
+            unmap();
+            std::swap(mapping, other.mapping);
+            std::swap(mapping_size, other.mapping_size);
+            std::swap(buffer, other.buffer);
+            std::swap(header, other.header);
+            std::swap(words, other.words);
+        }
+        return *this;
+    }
+    SieveCache(const SieveCache&) = delete;
+    SieveCache& operator=(const SieveCache&) = delete;
+    ~SieveCache() { unmap(); }
+
+    size_t limit() const { return header->limit; }
+
+    // Numbers above limit() report false, as with Sieve_struct
+    bool is_prime(size_t n) const { return Sieve_struct::is_prime(words, header->limit, n); }
+
+    // Re-reads the whole body, so it is left to the caller instead of done on every open
+    bool verify() const { return checksum(words, header->word_count) == header->checksum; }
+
+    static uint64_t checksum(const uint64_t* words, size_t count) {
+        uint64_t hash = 14695981039346656037ULL;
+        for (size_t i = 0; i < count; i++) {
+            hash = (hash ^ words[i]) * 1099511628211ULL;
+        }
+        return hash;
+    }
+
+    // Writes table next to path and renames it into place, so readers never see half a file
+    static void write(const std::string& path, const Sieve_struct& table) {
+        Sieve_cache_header header{};
+        std::memcpy(header.magic, "SIEVE30", 8);
+        header.version = VERSION;
+        header.wheel = 30;
+        header.limit = table.limit;
+        header.word_count = table.words.size();
+        header.checksum = checksum(table.words.data(), table.words.size());
+
+        // Unique per writing process and thread, so concurrent writers never share a temp file
+        std::string temp = path + ".tmp" + std::to_string(process_id()) + "-" +
+                           std::to_string(std::hash<std::thread::id>{}(std::this_thread::get_id()));
+        {
+            std::ofstream out(temp, std::ios::binary | std::ios::trunc);
+            out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+            out.write(reinterpret_cast<const char*>(table.words.data()),
+                      static_cast<std::streamsize>(table.words.size() * sizeof(uint64_t)));
+            if (!out) {
+                throw std::runtime_error("cannot write sieve cache " + temp);
+            }
+        }
+        std::filesystem::rename(temp, path);
+    }
+
+    private:
+    static long long process_id() {
+#if defined(_WIN32)
+        return _getpid();
+#elif defined(__unix__) || defined(__APPLE__)
+        return static_cast<long long>(getpid());
+#else
+        return 0;
+#endif
+    }
+
+    void* mapping = nullptr;
+    size_t mapping_size = 0;
+    std::vector<uint64_t> buffer; // file contents on platforms without mmap
+    const Sieve_cache_header* header = nullptr;
+    const uint64_t* words = nullptr;
+
+    SieveCache() = default;
+
+    // Maps path and checks its header; leaves the object unmapped when the file is missing or foreign
+    bool map(const std::string& path) {
+        const void* data = nullptr;
+        size_t size = 0;
+#if defined(__unix__) || defined(__APPLE__)
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) return false;
+        struct stat info;
+        if (fstat(fd, &info) == 0 && static_cast<size_t>(info.st_size) >= sizeof(Sieve_cache_header)) {
+            size = static_cast<size_t>(info.st_size);
+            void* mapped = mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+            if (mapped != MAP_FAILED) {
+                mapping = mapped;
+                mapping_size = size;
+                data = mapped;
+            }
+        }
+        ::close(fd);
+#else
+        std::ifstream in(path, std::ios::binary | std::ios::ate);
+        if (!in) return false;
+        size = static_cast<size_t>(in.tellg());
+        buffer.resize((size + 7) / 8);
+        in.seekg(0);
+        in.read(reinterpret_cast<char*>(buffer.data()), static_cast<std::streamsize>(size));
+        data = buffer.data();
+#endif
+        if (!data || size < sizeof(Sieve_cache_header)) {
+            unmap();
+            return false;
+        }
+
+        const auto* candidate = static_cast<const Sieve_cache_header*>(data);
+        bool valid = std::memcmp(candidate->magic, "SIEVE30", 8) == 0 && candidate->version == VERSION &&
+                     candidate->wheel == 30 && candidate->word_count == Sieve::word_count(candidate->limit) &&
+                     size == sizeof(Sieve_cache_header) + candidate->word_count * sizeof(uint64_t);
+        if (!valid) {
+            unmap();
+            return false;
+        }
+        header = candidate;
+        words = reinterpret_cast<const uint64_t*>(candidate + 1);
+        return true;
+    }
+
+    void unmap() {
+#if defined(__unix__) || defined(__APPLE__)
+        if (mapping) munmap(mapping, mapping_size);
+#endif
+        mapping = nullptr;
+        mapping_size = 0;
+        buffer.clear();
+        header = nullptr;
+        words = nullptr;
+    }
+};
+
+// Flattened results of a factorization batch: the prime factors of query i, with multiplicity
+// and ascending, are factors[offsets[i]] .. factors[offsets[i + 1] - 1]
+struct Factor_batch_struct {
+    std::vector<uint64_t> factors;
+    std::vector<size_t> offsets;
+};
+
+// Smallest prime factor of every odd n <= limit, built by a linear sieve that writes each
+// composite exactly once. Even numbers are not stored since their answer is always 2,
+// which halves the uint32 table. Queries above limit fall back to deterministic
+// Miller-Rabin (and Pollard-Brent rho for factorization), so every uint64_t is answered.
+class PrimeFactorTable {
+    public:
+    static constexpr size_t PREFETCH_DISTANCE = 16; // queries looked up ahead in a batch
+
+    explicit PrimeFactorTable(uint32_t limit) : table_limit(limit), spf(limit / 2 + 1, 0) {
+        std::vector<uint32_t> odd_primes;
+        for (uint64_t i = 3; i <= limit; i += 2) {
+            uint32_t& smallest = spf[i / 2];
+            if (smallest == 0) {
+                smallest = static_cast<uint32_t>(i);
+                odd_primes.push_back(static_cast<uint32_t>(i));
+            }
+            for (uint32_t p : odd_primes) {
+                if (p > smallest || i * p > limit) break;
+                spf[i * p / 2] = p;
+            }
+        }
+    }
+
+    uint32_t limit() const { return table_limit; }
+
+    // Smallest prime factor of 2 <= n <= limit()
+    uint64_t smallest_factor(uint64_t n) const {
+        return n % 2 == 0 ? 2 : spf[n / 2];
+    }
+
+    bool is_prime(uint64_t n) const {
+        if (n <= table_limit) {
+            return n == 2 || (n > 2 && n % 2 == 1 && spf[n / 2] == n);
+        }
+        return miller_rabin(n);
+    }
+
+    // Prime factors of n with multiplicity, ascending; empty for 0 and 1
+    std::vector<uint64_t> factorize(uint64_t n) const {
+        std::vector<uint64_t> factors;
+        append_factors(n, factors);
+        return factors;
+    }
+
+    // Batch lookup: results[i] = is_prime(queries[i]). Table entries for later queries
+    // are prefetched while earlier ones are answered, hiding the random-access misses.
+    void is_prime_batch(const uint64_t* queries, size_t count, uint8_t* results) const {
+        for (size_t i = 0; i < count; i++) {
+            if (i + PREFETCH_DISTANCE < count) prefetch(queries[i + PREFETCH_DISTANCE]);
+            results[i] = is_prime(queries[i]) ? 1 : 0;
+        }
+    }
+
+    std::vector<uint8_t> is_prime_batch(const std::vector<uint64_t>& queries) const {
+        std::vector<uint8_t> results(queries.size());
+        is_prime_batch(queries.data(), queries.size(), results.data());
+        return results;
+    }
+
+    Factor_batch_struct factorize_batch(const uint64_t* queries, size_t count) const {
+        Factor_batch_struct batch;
+        batch.offsets.reserve(count + 1);
+        batch.factors.reserve(count * 3);
+        batch.offsets.push_back(0);
+        for (size_t i = 0; i < count; i++) {
+            if (i + PREFETCH_DISTANCE < count) prefetch(queries[i + PREFETCH_DISTANCE]);
+            append_factors(queries[i], batch.factors);
+            batch.offsets.push_back(batch.factors.size());
+        }
+        return batch;
+    }
+
+    Factor_batch_struct factorize_batch(const std::vector<uint64_t>& queries) const {
+        return factorize_batch(queries.data(), queries.size());
+    }
+
+    // Deterministic for every 64-bit n (Jim Sinclair's seven bases)
+    static bool miller_rabin(uint64_t n) {
+        if (n < 2) return false;
+        for (uint64_t p : {2, 3, 5, 7, 11, 13, 17, 19, 23, 29, 31, 37}) {
+            if (n % p == 0) return n == p;
+        }
+        uint64_t d = n - 1;
+        int shift = 0;
+        while (d % 2 == 0) { d /= 2; shift++; }
+
+        for (uint64_t base : {2ULL, 325ULL, 9375ULL, 28178ULL, 450775ULL, 9780504ULL, 1795265022ULL}) {
+            uint64_t a = base % n;
+            if (a == 0) continue;
+            uint64_t x = pow_mod(a, d, n);
+            if (x == 1 || x == n - 1) continue;
+            bool witness = true;
+            for (int r = 1; r < shift && witness; r++) {
+                x = mul_mod(x, x, n);
+                if (x == n - 1) witness = false;
+            }
+            if (witness) return false;
+        }
+        return true;
+    }
+
+    static uint64_t mul_mod(uint64_t a, uint64_t b, uint64_t m) {
+#if defined(__SIZEOF_INT128__)
+        return static_cast<uint64_t>(static_cast<unsigned __int128>(a) * b % m);
+#else
+        uint64_t result = 0;
+        a %= m;
+        for (; b; b >>= 1) {
+            if (b & 1) result = (result >= m - a) ? result - (m - a) : result + a;
+            a = (a >= m - a) ? a - (m - a) : a + a;
+        }
+        return result;
+#endif
+    }
+
+    static uint64_t pow_mod(uint64_t base, uint64_t exponent, uint64_t m) {
+        uint64_t result = 1 % m;
+        for (base %= m; exponent; exponent >>= 1) {
+            if (exponent & 1) result = mul_mod(result, base, m);
+            base = mul_mod(base, base, m);
+        }
+        return result;
+    }
+
+    private:
+    uint32_t table_limit;
+    std::vector<uint32_t> spf; // spf[i] is the smallest prime factor of 2 * i + 1
+
+    void prefetch(uint64_t n) const {
+#if defined(__GNUC__) || defined(__clang__)
+        if (n <= table_limit) __builtin_prefetch(&spf[n / 2]);
+#else
+        (void)n;
+#endif
+    }
+
+    // Appends the prime factors of n in ascending order
+    void append_factors(uint64_t n, std::vector<uint64_t>& factors) const {
+        if (n < 2) return;
+        size_t first = factors.size();
+        while (n % 2 == 0) {
+            factors.push_back(2);
+            n /= 2;
+        }
+
+        // Split anything too large for the table with Pollard-Brent rho, explicit stack
+        std::vector<uint64_t> pending;
+        if (n > table_limit) {
+            pending.push_back(n);
+            n = 1;
+        }
+        while (!pending.empty()) {
+            uint64_t m = pending.back();
+            pending.pop_back();
+            if (m <= table_limit) {
+                append_small_factors(m, factors);
+            } else if (miller_rabin(m)) {
+                factors.push_back(m);
+            } else {
+                uint64_t d = pollard_brent(m);
+                pending.push_back(d);
+                pending.push_back(m / d);
+            }
+        }
+
+        append_small_factors(n, factors);
+        std::sort(factors.begin() + static_cast<std::ptrdiff_t>(first), factors.end());
+    }
+
+    // Odd n <= limit(), walked down the smallest-prime-factor chain
+    void append_small_factors(uint64_t n, std::vector<uint64_t>& factors) const {
+        while (n > 1) {
+            uint64_t p = smallest_factor(n);
+            factors.push_back(p);
+            n /= p;
+        }
+    }
+
+    // A non-trivial factor of an odd composite n
+    static uint64_t pollard_brent(uint64_t n) {
+        for (uint64_t p : {3, 5, 7, 11, 13, 17, 19, 23, 29, 31, 37}) {
+            if (n % p == 0) return p;
+        }
+        for (uint64_t c = 1;; c++) {
+            uint64_t y = 2, x = 2, q = 1, g = 1, saved = 2;
+            auto step = [&](uint64_t v) { return (mul_mod(v, v, n) + c) % n; };
+            for (uint64_t r = 1; g == 1; r *= 2) {
+                x = y;
+                for (uint64_t i = 0; i < r; i++) y = step(y);
+                for (uint64_t k = 0; k < r && g == 1; k += 128) {
+                    saved = y;
+                    for (uint64_t i = 0; i < std::min<uint64_t>(128, r - k); i++) {
+                        y = step(y);
+                        q = mul_mod(q, x > y ? x - y : y - x, n);
+                    }
+                    g = std::gcd(q, n);
+                }
+            }
+            if (g == n) {
+                // The batched product overshot, retrace one step at a time
+                do {
+                    saved = step(saved);
+                    g = std::gcd(x > saved ? x - saved : saved - x, n);
+                } while (g == 1);
+            }
+            if (g != n) return g;
+        }
+    }
+};
+
+namespace {
+    // Unit tests in anonymous namespace
+    void run_tests() {
+        std::cout << "Testing.." << '\n';
+
+        // Plain one-bool-per-integer sieve to check the faster layouts against
+        std::vector<bool> reference(100001, true);
+        reference[0] = reference[1] = false;
+        for (size_t i = 2; i * i <= 100000; i++) {
+            if (reference[i]) {
+                for (size_t j = i * i; j <= 100000; j += i) reference[j] = false;
+            }
+        }
+
+        // Test: the wheel table agrees with the plain sieve for every limit near the byte edges
+        for (size_t limit : {0, 1, 2, 6, 29, 30, 31, 239, 240, 241, 1001 * 30 + 7, 100000}) {
+            Sieve_struct wheel = Sieve::initialize(limit);
+            for (size_t n = 0; n <= limit + 40; n++) {
+                assert(wheel.is_prime(n) == (n <= limit && reference[n]));
+            }
+        }
+
+        // Test: a table spanning several cross-off blocks
+        assert(Sieve::get_primes(Sieve::initialize(20000000)).size() == 1270607);
+
+        // Test: popcount counting and tzcnt extraction over arbitrary windows, limit included
+        Sieve_struct table = Sieve::initialize(100000);
+        assert(Sieve::get_primes(Sieve::initialize(29)).back() == 29);
+        for (const auto& [low, high] : std::vector<std::pair<size_t, size_t>>{
+                 {0, 100000}, {0, 0}, {2, 5}, {7, 7}, {8, 10}, {30, 31}, {1000, 1920}, {12345, 99999}, {64000, 200000}}) {
+            std::vector<size_t> expected;
+            for (size_t i = low; i <= std::min<size_t>(high, 100000); i++) {
+                if (reference[i]) expected.push_back(i);
+            }
+            assert(Sieve::get_primes(table, low, high) == expected);
+            assert(Sieve::count_primes(table, low, high) == expected.size());
+        }
+
+        // Test: extending a table only sieves the new part but matches a fresh build
+        for (const auto& [from, to] : std::vector<std::pair<size_t, size_t>>{{0, 100}, {29, 31}, {100, 100000}, {7, 1000}}) {
+            Sieve_struct grown = Sieve::initialize(from);
+            Sieve::extend(grown, to);
+            assert(grown.limit == to && grown.words == Sieve::initialize(to).words);
+        }
+
+        // Test: the cache file is built, reused, extended and survives a corrupted header
+        {
+            std::string path = (std::filesystem::temp_directory_path() / "sieve_cache_test.bin").string();
+            std::filesystem::remove(path);
+
+            SieveCache built = SieveCache::open(path, 1000);
+            assert(built.limit() == 1000 && built.verify());
+            assert(SieveCache::open(path, 500).limit() == 1000);
+
+            SieveCache extended = SieveCache::open(path, 100000);
+            assert(extended.limit() == 100000 && extended.verify());
+            for (size_t n = 0; n <= 100010; n++) {
+                assert(extended.is_prime(n) == (n <= 100000 && reference[n]));
+            }
+            assert(built.is_prime(997)); // the old mapping stays readable after the file is replaced
+
+            std::fstream(path, std::ios::in | std::ios::out | std::ios::binary).write("garbage!", 8);
+            assert(SieveCache::open(path, 100).limit() == 100);
+            std::filesystem::remove(path);
+        }
+
+        // Test: smallest-prime-factor table, batch API and the Miller-Rabin fallback
+        {
+            PrimeFactorTable factors(100000);
+            std::vector<uint64_t> queries;
+            for (uint64_t n = 0; n <= 100100; n++) queries.push_back(n);
+            std::vector<uint8_t> answers = factors.is_prime_batch(queries);
+            for (uint64_t n = 0; n <= 100100; n++) {
+                bool expected = n <= 100000 ? reference[n] : PrimeFactorTable::miller_rabin(n);
+                assert(answers[n] == expected);
+            }
+
+            const uint64_t big_prime = 18446744073709551557ULL;
+            assert(factors.is_prime(2305843009213693951ULL) && factors.is_prime(big_prime));
+            assert(!factors.is_prime(3215031751ULL) && !factors.is_prime(561));
+
+            std::vector<uint64_t> hard = {0, 1, 2, 97, 1024, 99991, 100003ULL * 100019ULL, 18446744073709551615ULL,
+                                          4611686014132420609ULL /* (2^31 - 1)^2 */, big_prime};
+            Factor_batch_struct batch = factors.factorize_batch(hard);
+            assert(factors.factorize(18446744073709551615ULL) ==
+                   (std::vector<uint64_t>{3, 5, 17, 257, 641, 65537, 6700417}));
+            for (size_t i = 0; i < hard.size(); i++) {
+                uint64_t product = 1;
+                for (size_t j = batch.offsets[i]; j < batch.offsets[i + 1]; j++) {
+                    assert(factors.is_prime(batch.factors[j]));
+                    product *= batch.factors[j];
+                }
+                assert(hard[i] < 2 ? batch.offsets[i] == batch.offsets[i + 1] : product == hard[i]);
+            }
+        }
+
+        // Test: segmented windows match the plain sieve, including the edges
+        std::vector<std::pair<uint64_t, uint64_t>> windows = {
+            {0, 100000}, {0, 1}, {2, 2}, {1, 30}, {24, 29}, {99000, 100000}, {4097, 65537}
+        };
+        for (const auto& [low, high] : windows) {
+            std::vector<size_t> expected;
+            for (size_t i = low; i <= high; i++) {
+                if (reference[i]) expected.push_back(i);
+            }
+            SegmentedSieve small_segments(low, high, 64);
+            assert(small_segments.get_primes() == expected);
+            assert(SegmentedSieve(low, high).count_primes() == expected.size());
+        }
+
+        // Test: the parallel sieve merges segments back in order
+        for (unsigned threads : {1u, 2u, 7u}) {
+            ParallelSieve parallel(0, 100000, threads, 64);
+            assert(parallel.get_primes() == SegmentedSieve(0, 100000).get_primes());
+            assert(parallel.count_primes() == 9592);
+        }
+        assert(ParallelSieve(2, 2, 4).get_primes() == std::vector<size_t>{2});
+
+        // Test: the lazy range matches the eager sieves and can stop early
+        {
+            std::vector<size_t> streamed;
+            for (auto prime : primes_from(0)) {
+                if (prime > 100000) break;
+                streamed.push_back(prime);
+            }
+            assert(streamed == Sieve::get_primes(table));
+
+            streamed.clear();
+            PrimeRange window(99000, 100000, 64);
+            for (auto prime : window) streamed.push_back(prime);
+            assert(streamed == Sieve::get_primes(table, 99000, 100000));
+
+            size_t far_count = 0;
+            for (auto prime : PrimeRange(1000000000, 1000001000)) {
+                assert(prime >= 1000000000 && prime <= 1000001000);
+                far_count++;
+            }
+            assert(far_count == 49);
+
+            // A walk long enough to extend its base primes on the way
+            size_t walked = 0;
+            for (auto prime : PrimeRange(40000000, 50000000, 1024)) {
+                (void)prime;
+                walked++;
+            }
+            assert(walked == SegmentedSieve(40000000, 50000000).count_primes());
+
+            // Goldbach for one even number: stream primes only until a partner shows up
+            const size_t even = 99998;
+            size_t partner = 0;
+            for (auto prime : primes_from(2)) {
+                if (table.is_prime(even - prime)) { partner = prime; break; }
+            }
+            assert(partner != 0 && table.is_prime(partner) && table.is_prime(even - partner));
+        }
+
+        // Test: segments that end at 2^64 - 1 cross off exactly the multiples of their base
+        // primes, carrying offsets from one segment to the next without wrapping
+        {
+            const uint64_t top = std::numeric_limits<uint64_t>::max();
+            std::vector<uint32_t> small = SegmentedSieve::base_primes_up_to(1000);
+            Segment_struct segment;
+            for (uint64_t seg_low : {top - 200, top - 100}) {
+                SegmentedSieve::sieve_segment(segment, seg_low, seg_low == top - 200 ? top - 101 : top, small);
+                for (size_t i = 0; i < segment.composite.size(); i++) {
+                    uint64_t value = seg_low + 2 * i;
+                    bool divisible = std::any_of(small.begin(), small.end(), [value](uint32_t p) {return value % p == 0;});
+                    assert(static_cast<bool>(segment.composite[i]) == divisible);
+                }
+            }
+        }
+
+        // Test: known prime counts far away from zero
+        assert(SegmentedSieve(0, 10000000).count_primes() == 664579);
+        assert(SegmentedSieve(1000000000, 1000001000).count_primes() == 49);
+
+        std::cout << "All tests passed!" << '\n';
+    }
+
+    // Throughput of a fixed-width window as it moves towards 10^12
+    void run_benchmarks() {
+        const uint64_t width = 10000000;
+        std::cout << "Segmented sieve, window of " << width << " numbers:\n";
+        for (uint64_t high = 100000000; high <= 1000000000000ULL; high *= 10) {
+            auto start = std::chrono::steady_clock::now();
+            size_t count = SegmentedSieve(high - width, high).count_primes();
+            std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+            std::cout << "  high = " << high << ": " << count << " primes in "
+                      << elapsed.count() * 1000 << " ms ("
+                      << width / elapsed.count() / 1e6 << " M numbers/s)\n";
+        }
+
+        {
+            Sieve_struct table = Sieve::initialize(1000000000);
+            auto start = std::chrono::steady_clock::now();
+            size_t count = Sieve::count_primes(table, 0, table.limit);
+            std::chrono::duration<double> counted = std::chrono::steady_clock::now() - start;
+            start = std::chrono::steady_clock::now();
+            size_t extracted = Sieve::get_primes(table).size();
+            std::chrono::duration<double> decoded = std::chrono::steady_clock::now() - start;
+            std::cout << "pi(10^9) = " << count << ": popcount " << counted.count() * 1000
+                      << " ms, extracting " << extracted << " primes " << decoded.count() * 1000 << " ms\n";
+        }
+
+        {
+            std::string path = (std::filesystem::temp_directory_path() / "sieve_cache_bench.bin").string();
+            std::filesystem::remove(path);
+            auto start = std::chrono::steady_clock::now();
+            SieveCache::open(path, 1000000000);
+            std::chrono::duration<double> built = std::chrono::steady_clock::now() - start;
+            start = std::chrono::steady_clock::now();
+            SieveCache warm = SieveCache::open(path, 1000000000);
+            bool answer = warm.is_prime(999999937);
+            std::chrono::duration<double> opened = std::chrono::steady_clock::now() - start;
+            std::cout << "Sieve cache to 10^9: build " << built.count() * 1000 << " ms, warm open + lookup "
+                      << opened.count() * 1e6 << " us (" << (answer ? "prime" : "composite") << ")\n";
+            std::filesystem::remove(path);
+        }
+
+        {
+            const uint32_t limit = 100000000;
+            auto start = std::chrono::steady_clock::now();
+            PrimeFactorTable factors(limit);
+            std::chrono::duration<double> built = std::chrono::steady_clock::now() - start;
+            std::cout << "Smallest-prime-factor table to " << limit << " built in " << built.count() * 1000 << " ms\n";
+
+            std::mt19937_64 rng(42);
+            std::uniform_real_distribution<double> unit(0.0, 1.0);
+            const size_t count = 2000000;
+            std::vector<std::pair<std::string, std::vector<uint64_t>>> workloads(3);
+            workloads[0].first = "uniform";
+            workloads[1].first = "skewed (u^4)";
+            workloads[2].first = "above table (Miller-Rabin)";
+            for (size_t i = 0; i < count; i++) {
+                double u = unit(rng);
+                workloads[0].second.push_back(1 + static_cast<uint64_t>(u * (limit - 1)));
+                workloads[1].second.push_back(1 + static_cast<uint64_t>(u * u * u * u * (limit - 1)));
+                workloads[2].second.push_back(rng() | 1);
+            }
+            for (const auto& [name, queries] : workloads) {
+                start = std::chrono::steady_clock::now();
+                std::vector<uint8_t> answers = factors.is_prime_batch(queries);
+                std::chrono::duration<double> checked = std::chrono::steady_clock::now() - start;
+                size_t factored = name[0] == 'a' ? count / 100 : count;
+                start = std::chrono::steady_clock::now();
+                Factor_batch_struct batch = factors.factorize_batch(queries.data(), factored);
+                std::chrono::duration<double> split = std::chrono::steady_clock::now() - start;
+                std::cout << "  " << name << ": is_prime " << count / checked.count() / 1e6 << " M queries/s, factorize "
+                          << factored / split.count() / 1e6 << " M queries/s ("
+                          << std::count(answers.begin(), answers.end(), 1) << " primes, "
+                          << batch.factors.size() << " factors)\n";
+            }
+        }
+
+        const uint64_t low = 100000000000ULL, high = low + 1000000000ULL;
+        unsigned max_threads = std::max(std::thread::hardware_concurrency(), 1u);
+        double single_thread = 0;
+        std::cout << "Parallel sieve over [" << low << ", " << high << "]:\n";
+        for (unsigned threads = 1; threads <= max_threads; threads++) {
+            auto start = std::chrono::steady_clock::now();
+            size_t count = ParallelSieve(low, high, threads).count_primes();
+            std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+            if (threads == 1) single_thread = elapsed.count();
+            std::cout << "  " << threads << " thread(s): " << count << " primes in "
+                      << elapsed.count() * 1000 << " ms (speedup "
+                      << single_thread / elapsed.count() << "x)\n";
+        }
+    }
+}
+
+int main(int argc, char* argv[]) {
     int limit = 30;
     Sieve_struct sieve = Sieve::initialize(limit);
     std::vector<size_t> primes = Sieve::get_primes(sieve);
@@ -72,6 +1373,13 @@ int main() {
         std::cout << prime << " ";
     }
     std::cout << std::endl;
+
+    run_tests();
+
+    // pass --bench to measure segmented and parallel sieve throughput
+    if (argc > 1 && std::string(argv[1]) == "--bench") {
+        run_benchmarks();
+    }
     
     return 0;
 }
\ No newline at end of file
@@ -22,12 +22,220 @@ im just translating the rust version, did you think i would use my brain?
 #include <unordered_map>
 #include <vector>
 #include <string>
+#include <cstdint>
+#include <cassert>
+#include <chrono>
+#include <random>
+#include <thread>
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <filesystem>
+#include <stdexcept>
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+// Euler status from the number of odd-degree vertices and whether the edges form one
+// connected piece, shared by both graph types
+inline std::string describe_eulerian(uint64_t odd_degree_count, bool connected) {
+    if (!connected) {
+        return "No Eulerian path or circuit exists (the edges do not form one connected graph).";
+    } else if (odd_degree_count == 0) {
+        return "This graph has an Eulerian circuit (all vertices have an even degree).";
+    } else if (odd_degree_count == 2) {
+        return "This graph has an Eulerian path (exactly two vertices have an odd degree).";
+    } else { return "No Eulerian path or circuit exists."; }
+}
+
+/// Disjoint sets over vertex IDs with path halving and union by size
+class UnionFind {
+private:
+    std::vector<uint32_t> parent;
+    std::vector<uint32_t> size;
+
+public:
+    explicit UnionFind(uint32_t count = 0) : parent(count), size(count, 1) {
+        for (uint32_t v = 0; v < count; v++) parent[v] = v;
+    }
+
+    // Grows the universe with singleton sets up to count elements
+    void resize(uint32_t count) {
+        for (uint32_t v = static_cast<uint32_t>(parent.size()); v < count; v++) {
+            parent.push_back(v);
+            size.push_back(1);
+        }
+    }
+
+    uint32_t find(uint32_t v) {
+        while (parent[v] != v) {
+            parent[v] = parent[parent[v]];
+            v = parent[v];
+        }
+        return v;
+    }
+
+    // Returns true when a and b were in different sets
+    bool unite(uint32_t a, uint32_t b) {
+        a = find(a);
+        b = find(b);
+        if (a == b) return false;
+        if (size[a] < size[b]) std::swap(a, b);
+        parent[b] = a;
+        size[a] += size[b];
+        return true;
+    }
+
+    uint32_t set_size(uint32_t v) {return size[find(v)];}
+};
+
+/// Undirected multigraph in compressed sparse row form with uint32_t vertex IDs.
+/// The neighbours of v are targets[offsets[v] .. offsets[v + 1]), every edge is stored
+/// from both ends (a self-loop twice at its vertex) with the edge's index in the input list
+/// alongside it in edge_ids. Offsets are 64-bit since up to 2^32 - 1 edges fill twice as many slots.
+class CsrGraph {
+private:
+    std::vector<uint64_t> offsets;
+    std::vector<uint32_t> targets;
+    std::vector<uint32_t> edge_ids;
+
+public:
+    CsrGraph() : offsets(1, 0) {}
+
+    // Built in two counting-sort passes: degrees into offsets and a prefix sum, then every
+    // edge scattered into its two slots. Neighbours keep the order of the edge list.
+    CsrGraph(uint32_t vertex_count, const std::pair<uint32_t, uint32_t>* edges, size_t edge_count)
+        : offsets(static_cast<size_t>(vertex_count) + 1, 0), targets(2 * edge_count), edge_ids(2 * edge_count) {
+        for (size_t i = 0; i < edge_count; i++) {
+            offsets[edges[i].first + 1]++;
+            offsets[edges[i].second + 1]++;
+        }
+        for (uint32_t v = 0; v < vertex_count; v++) {
+            offsets[v + 1] += offsets[v];
+        }
+        std::vector<uint64_t> cursor(offsets.begin(), offsets.end() - 1);
+        for (size_t i = 0; i < edge_count; i++) {
+            const auto [u, v] = edges[i];
+            edge_ids[cursor[u]] = static_cast<uint32_t>(i);
+            targets[cursor[u]++] = v;
+            edge_ids[cursor[v]] = static_cast<uint32_t>(i);
+            targets[cursor[v]++] = u;
+        }
+    }
+
+    CsrGraph(uint32_t vertex_count, const std::vector<std::pair<uint32_t, uint32_t>>& edges)
+        : CsrGraph(vertex_count, edges.data(), edges.size()) {}
+
+    uint32_t vertex_count() const {return static_cast<uint32_t>(offsets.size() - 1);}
+    uint64_t edge_count() const {return targets.size() / 2;}
+    uint64_t degree(uint32_t v) const {return offsets[v + 1] - offsets[v];}
+    const uint32_t* neighbors_begin(uint32_t v) const {return targets.data() + offsets[v];}
+    const uint32_t* neighbors_end(uint32_t v) const {return targets.data() + offsets[v + 1];}
+    const std::vector<uint64_t>& get_offsets() const {return offsets;}
+
+    // Odd-degree vertices as a parallel reduction over the offsets array: the degree of v is
+    // odd exactly when offsets[v] and offsets[v + 1] differ in their lowest bit, so every
+    // thread sums XORs over its own slice and only the per-thread totals are combined.
+    uint64_t count_odd_degrees(unsigned threads = std::thread::hardware_concurrency()) const {
+        const uint64_t vertices = vertex_count();
+        threads = static_cast<unsigned>(std::max<uint64_t>(1, std::min<uint64_t>(std::max(threads, 1u), vertices / 65536 + 1)));
+        std::vector<uint64_t> partial(threads, 0);
+        auto count_slice = [this, &partial, vertices, threads](unsigned slice) {
+            const uint64_t* offset = offsets.data();
+            uint64_t odd = 0;
+            for (uint64_t v = vertices * slice / threads, end = vertices * (slice + 1) / threads; v < end; v++) {
+                odd += (offset[v] ^ offset[v + 1]) & 1;
+            }
+            partial[slice] = odd;
+        };
+        std::vector<std::thread> workers;
+        for (unsigned slice = 1; slice < threads; slice++) {
+            workers.emplace_back(count_slice, slice);
+        }
+        count_slice(0);
+        for (auto& worker : workers) {
+            worker.join();
+        }
+        uint64_t odd = 0;
+        for (uint64_t count : partial) odd += count;
+        return odd;
+    }
+
+    // True when every vertex with an edge is in one component: one union-find pass over the
+    // edges, then every endpoint checked against the first one. Isolated vertices do not count.
+    bool edges_connected() const {
+        UnionFind components(vertex_count());
+        uint32_t first = UINT32_MAX;
+        for (uint32_t v = 0; v < vertex_count(); v++) {
+            for (uint64_t slot = offsets[v]; slot < offsets[v + 1]; slot++) {
+                if (targets[slot] > v) components.unite(v, targets[slot]);
+            }
+            if (first == UINT32_MAX && degree(v) != 0) first = v;
+        }
+        for (uint32_t v = first; v < vertex_count(); v++) {
+            if (degree(v) != 0 && components.find(v) != components.find(first)) return false;
+        }
+        return true;
+    }
+
+    std::string analyze_elerian(unsigned threads = std::thread::hardware_concurrency()) const {
+        return describe_eulerian(count_odd_degrees(threads), edges_connected());
+    }
+
+    // Eulerian circuit or path as the sequence of vertices visited, edge_count() + 1 entries,
+    // or empty when none exists. Iterative Hierholzer: an explicit stack of vertices, a cursor
+    // per vertex into its neighbour slots, and one used bit per edge so that the second slot
+    // of an edge (and every parallel edge) is consumed exactly once. O(V + E) with no recursion.
+    std::vector<uint32_t> eulerian_walk() const {
+        if (edge_count() == 0 || !edges_connected()) return {};
+        // A path has to start at one of its two odd vertices, a circuit anywhere on an edge
+        uint32_t start = UINT32_MAX, odd = 0;
+        for (uint32_t v = 0; v < vertex_count(); v++) {
+            if (degree(v) % 2 != 0 && odd++ == 0) start = v;
+        }
+        if (odd != 0 && odd != 2) return {};
+        if (odd == 0) {
+            start = 0;
+            while (degree(start) == 0) start++;
+        }
+
+        std::vector<uint64_t> used((edge_count() + 63) / 64, 0);
+        std::vector<uint64_t> cursor(offsets.begin(), offsets.end() - 1);
+        std::vector<uint32_t> stack{start}, walk;
+        walk.reserve(edge_count() + 1);
+        while (!stack.empty()) {
+            const uint32_t v = stack.back();
+            uint64_t& slot = cursor[v];
+            while (slot < offsets[v + 1] && (used[edge_ids[slot] / 64] >> (edge_ids[slot] % 64) & 1)) slot++;
+            if (slot == offsets[v + 1]) {
+                walk.push_back(v);
+                stack.pop_back();
+            } else {
+                used[edge_ids[slot] / 64] |= uint64_t{1} << (edge_ids[slot] % 64);
+                stack.push_back(targets[slot++]);
+            }
+        }
+        std::reverse(walk.begin(), walk.end());
+        return walk;
+    }
+};
 
  /// Represents a graph structure using adjacency list
 class Graph {
 private:
-    // Equivalent to Rust's HashMap<char, Vec<char>>
-    std::unordered_map<char, std::vector<char>> adjacency_list;
+    // Vertex labels map to dense IDs in order of first appearance
+    std::unordered_map<char, uint32_t> vertex_ids;
+    std::vector<char> labels;
+    CsrGraph csr;
+
+    uint32_t id_of(char label) {
+        auto [it, inserted] = vertex_ids.try_emplace(label, static_cast<uint32_t>(labels.size()));
+        if (inserted) labels.push_back(label);
+        return it->second;
+    }
 
 public:
     // Default constructor
@@ -35,37 +243,326 @@ public:
 
     // Creates a new graph with given edges
     Graph(const std::vector<std::pair<char, char>>& edges) {
+        std::vector<std::pair<uint32_t, uint32_t>> ids;
+        ids.reserve(edges.size());
         for (const auto& [u, v] : edges) {
-            adjacency_list[u].push_back(v);
-            adjacency_list[v].push_back(u);
+            uint32_t from = id_of(u);
+            ids.emplace_back(from, id_of(v));
         }
+        csr = CsrGraph(static_cast<uint32_t>(labels.size()), ids);
     }
 
-    // Getter for adjacency list (useful for testing and verification)
-    const std::unordered_map<char, std::vector<char>>& get_adjacency_list() const {
+    // Adjacency list rebuilt from the CSR form (useful for testing and verification)
+    std::unordered_map<char, std::vector<char>> get_adjacency_list() const {
+        std::unordered_map<char, std::vector<char>> adjacency_list;
+        for (uint32_t v = 0; v < csr.vertex_count(); v++) {
+            std::vector<char>& neighbors = adjacency_list[labels[v]];
+            for (const uint32_t* it = csr.neighbors_begin(v); it != csr.neighbors_end(v); ++it) {
+                neighbors.push_back(labels[*it]);
+            }
+        }
         return adjacency_list;
     }
 
+    const CsrGraph& get_csr() const {return csr;}
+
+    // Degree of every vertex as one string, instead of one console write per vertex
+    std::string degree_report() const {
+        std::string report;
+        for (uint32_t v = 0; v < csr.vertex_count(); v++) {
+            report += "Vertex ";
+            report += labels[v];
+            report += " has degree " + std::to_string(csr.degree(v)) + "\n";
+        }
+        return report;
+    }
+
     // Determines the degree of each node and checks for Eulerian path or circuit
     std::string analyze_elerian() const {
-        int odd_degree_const = 0;
-        for (const auto& [node, neighbors] : adjacency_list) {
-            int degree = neighbors.size();
-            std::cout << "Vertex" << node << "has degree" << degree;
+        return csr.analyze_elerian(1);
+    }
+
+    // The route itself as vertex labels, empty when no Eulerian path or circuit exists
+    std::vector<char> eulerian_route() const {
+        std::vector<char> route;
+        for (uint32_t v : csr.eulerian_walk()) route.push_back(labels[v]);
+        return route;
+    }
+};
 
-            if (degree % 2 != 0) {
-                odd_degree_const++;
+// Binary edge list: this header, then edge_count pairs of uint32_t vertex IDs in native byte order
+struct edge_file_header {
+    char magic[8];          // "EDGES01"
+    uint64_t edge_count;
+};
+
+/// Read-only memory mapping of an edge list file, either binary (edge_file_header first) or
+/// text with one "u v" pair of decimal IDs per line. Text lines starting with '#' or '%' and
+/// anything after the second ID on a line are ignored, so SNAP and Matrix Market style files
+/// load as they are. Text is parsed in parallel chunks split at line boundaries with a
+/// hand-rolled integer parser; binary edges are handed out straight from the mapping.
+class EdgeFile {
+private:
+    void* mapping = nullptr;
+    size_t mapping_size = 0;
+    std::vector<char> buffer;       // file contents on platforms without mmap
+    const char* data = nullptr;
+    size_t size = 0;
+    bool binary = false;
+
+    EdgeFile() = default;
+
+    void unmap() {
+#if defined(__unix__) || defined(__APPLE__)
+        if (mapping) munmap(mapping, mapping_size);
+#endif
+        mapping = nullptr;
+        mapping_size = 0;
+        buffer.clear();
+        data = nullptr;
+        size = 0;
+    }
+
+    // Parses whole lines of text in [begin, end) into out; false on a line without two IDs
+    static bool parse_text(const char* begin, const char* end, std::vector<std::pair<uint32_t, uint32_t>>& out) {
+        const char* p = begin;
+        while (p < end) {
+            while (p < end && (*p == ' ' || *p == '\t' || *p == '\r' || *p == '\n')) p++;
+            if (p == end) break;
+            if (*p == '#' || *p == '%') {
+                while (p < end && *p != '\n') p++;
+                continue;
             }
+            uint32_t u, v;
+            if (!parse_uint(p, end, u)) return false;
+            while (p < end && (*p == ' ' || *p == '\t' || *p == ',')) p++;
+            if (!parse_uint(p, end, v)) return false;
+            out.emplace_back(u, v);
+            while (p < end && *p != '\n') p++;
         }
+        return true;
+    }
 
-        if (odd_degree_const == 0) {
-            return "This graph has an Eulerian circuit (all vertices have an even degree).";
-        } else if (odd_degree_const == 2) {
-            return "This graph has an Eulerian path (exactly two vertices have an odd degree).";
-        } else { return "No Eulerian path or circuit exists."; }
+    // Vertex IDs stop at UINT32_MAX - 1, so the vertex count still fits in uint32_t
+    static bool parse_uint(const char*& p, const char* end, uint32_t& value) {
+        uint64_t result = 0;
+        const char* start = p;
+        while (p < end && static_cast<unsigned char>(*p - '0') < 10 && result < UINT32_MAX) {
+            result = result * 10 + static_cast<unsigned>(*p++ - '0');
+        }
+        value = static_cast<uint32_t>(result);
+        return p != start && result < UINT32_MAX;
+    }
+
+    // Splits [begin, end) into one run of whole lines per thread and parses them side by side,
+    // keeping the edges in file order
+    static std::vector<std::pair<uint32_t, uint32_t>> parse_parallel(const char* begin, const char* end, unsigned threads) {
+        const size_t bytes = static_cast<size_t>(end - begin);
+        threads = static_cast<unsigned>(std::max<size_t>(1, std::min<size_t>(std::max(threads, 1u), bytes / (1 << 20) + 1)));
+        std::vector<const char*> cuts{begin};
+        for (unsigned t = 1; t < threads; t++) {
+            const char* cut = std::max(cuts.back(), begin + bytes * t / threads);
+            while (cut < end && cut[-1] != '\n') cut++;
+            cuts.push_back(cut);
+        }
+        cuts.push_back(end);
+
+        std::vector<std::vector<std::pair<uint32_t, uint32_t>>> parts(threads);
+        std::vector<char> ok(threads, 1);
+        auto parse_part = [&](unsigned t) {
+            parts[t].reserve(static_cast<size_t>(cuts[t + 1] - cuts[t]) / 12);
+            ok[t] = parse_text(cuts[t], cuts[t + 1], parts[t]);
+        };
+        std::vector<std::thread> workers;
+        for (unsigned t = 1; t < threads; t++) {
+            workers.emplace_back(parse_part, t);
+        }
+        parse_part(0);
+        for (auto& worker : workers) {
+            worker.join();
+        }
+        if (std::find(ok.begin(), ok.end(), 0) != ok.end()) {
+            throw std::runtime_error("malformed line in edge list");
+        }
+
+        if (threads == 1) return std::move(parts[0]);
+        size_t total = 0;
+        for (const auto& part : parts) total += part.size();
+        std::vector<std::pair<uint32_t, uint32_t>> edges;
+        edges.reserve(total);
+        for (const auto& part : parts) edges.insert(edges.end(), part.begin(), part.end());
+        return edges;
+    }
+
+public:
+    static EdgeFile open(const std::string& path) {
+        EdgeFile file;
+#if defined(__unix__) || defined(__APPLE__)
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) throw std::runtime_error("cannot open edge list " + path);
+        struct stat info;
+        if (fstat(fd, &info) == 0 && info.st_size > 0) {
+            file.mapping_size = static_cast<size_t>(info.st_size);
+            void* mapped = mmap(nullptr, file.mapping_size, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (mapped == MAP_FAILED) {
+                ::close(fd);
+                throw std::runtime_error("cannot map edge list " + path);
+            }
+            madvise(mapped, file.mapping_size, MADV_SEQUENTIAL);
+            file.mapping = mapped;
+            file.data = static_cast<const char*>(mapped);
+            file.size = file.mapping_size;
+        }
+        ::close(fd);
+#else
+        std::ifstream in(path, std::ios::binary | std::ios::ate);
+        if (!in) throw std::runtime_error("cannot open edge list " + path);
+        file.buffer.resize(static_cast<size_t>(in.tellg()));
+        in.seekg(0);
+        in.read(file.buffer.data(), static_cast<std::streamsize>(file.buffer.size()));
+        file.data = file.buffer.data();
+        file.size = file.buffer.size();
+#endif
+        file.binary = file.size >= sizeof(edge_file_header) && std::memcmp(file.data, "EDGES01", 8) == 0;
+        if (file.binary) {
+            const auto* header = reinterpret_cast<const edge_file_header*>(file.data);
+            // Divide before multiplying: edge_count comes from the file and could overflow the product
+            const uint64_t capacity = (file.size - sizeof(edge_file_header)) / sizeof(std::pair<uint32_t, uint32_t>);
+            if (header->edge_count > capacity ||
+                file.size != sizeof(edge_file_header) + header->edge_count * sizeof(std::pair<uint32_t, uint32_t>)) {
+                throw std::runtime_error("truncated binary edge list " + path);
+            }
+        }
+        return file;
+    }
+
+    EdgeFile(EdgeFile&& other) noexcept { *this = std::move(other); }
+    EdgeFile& operator=(EdgeFile&& other) noexcept {
+        if (this != &other) {
+            unmap();
+            std::swap(mapping, other.mapping);
+            std::swap(mapping_size, other.mapping_size);
+            std::swap(buffer, other.buffer);
+            std::swap(data, other.data);
+            std::swap(size, other.size);
+            std::swap(binary, other.binary);
+        }
+        return *this;
+    }
+    EdgeFile(const EdgeFile&) = delete;
+    EdgeFile& operator=(const EdgeFile&) = delete;
+    ~EdgeFile() { unmap(); }
+
+    bool is_binary() const {return binary;}
+    size_t bytes() const {return size;}
+
+    // Calls callback(edges, count) with consecutive batches in file order. Binary batches point
+    // into the mapping; text is parsed one window of about window_bytes at a time, so memory
+    // stays bounded however large the file is.
+    template <typename Callback>
+    void for_each_batch(Callback callback, size_t window_bytes = size_t{64} << 20,
+                        unsigned threads = std::thread::hardware_concurrency()) const {
+        if (binary) {
+            const auto* edges = reinterpret_cast<const std::pair<uint32_t, uint32_t>*>(data + sizeof(edge_file_header));
+            const uint64_t count = reinterpret_cast<const edge_file_header*>(data)->edge_count;
+            const size_t batch = std::max<size_t>(1, window_bytes / sizeof(*edges));
+            for (uint64_t first = 0; first < count; first += batch) {
+                callback(edges + first, static_cast<size_t>(std::min<uint64_t>(batch, count - first)));
+            }
+            return;
+        }
+        const char* end = data + size;
+        for (const char* window = data; window < end;) {
+            const char* cut = window + std::min<size_t>(std::max<size_t>(window_bytes, 1), static_cast<size_t>(end - window));
+            while (cut < end && cut[-1] != '\n') cut++;
+            std::vector<std::pair<uint32_t, uint32_t>> edges = parse_parallel(window, cut, threads);
+            if (!edges.empty()) callback(static_cast<const std::pair<uint32_t, uint32_t>*>(edges.data()), edges.size());
+            window = cut;
+        }
+    }
+
+    // Every edge, for the CSR builder
+    std::vector<std::pair<uint32_t, uint32_t>> read_all(unsigned threads = std::thread::hardware_concurrency()) const {
+        if (!binary) return parse_parallel(data, data + size, threads);
+        std::vector<std::pair<uint32_t, uint32_t>> edges;
+        for_each_batch([&edges](const std::pair<uint32_t, uint32_t>* batch, size_t count) {
+            edges.insert(edges.end(), batch, batch + count);
+        }, size, threads);
+        return edges;
+    }
+
+    // CSR graph over vertices 0 .. max ID; a binary file can hold ID UINT32_MAX, which is rejected
+    CsrGraph to_csr(unsigned threads = std::thread::hardware_concurrency()) const {
+        std::vector<std::pair<uint32_t, uint32_t>> edges = read_all(threads);
+        uint64_t vertices = 0;
+        for (const auto& [u, v] : edges) vertices = std::max<uint64_t>(vertices, uint64_t{std::max(u, v)} + 1);
+        if (vertices > UINT32_MAX) throw std::runtime_error("vertex ID out of range in edge list");
+        return CsrGraph(static_cast<uint32_t>(vertices), edges);
+    }
+
+    static void write_binary(const std::string& path, const std::vector<std::pair<uint32_t, uint32_t>>& edges) {
+        edge_file_header header{};
+        std::memcpy(header.magic, "EDGES01", 8);
+        header.edge_count = edges.size();
+        std::ofstream out(path, std::ios::binary | std::ios::trunc);
+        out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        out.write(reinterpret_cast<const char*>(edges.data()), static_cast<std::streamsize>(edges.size() * sizeof(edges[0])));
+        if (!out) throw std::runtime_error("cannot write edge list " + path);
     }
 };
 
+/// Euler status kept up to date while edges arrive, with no graph stored: one parity bit per
+/// vertex flips with every edge end, and a union-find counts components among the vertices
+/// seen so far (touched vertices minus successful unions). add_edges costs O(count α(V)).
+class IncrementalEuler {
+private:
+    std::vector<uint64_t> odd_bits;
+    std::vector<uint64_t> touched_bits;
+    UnionFind components;
+    uint32_t vertices = 0;
+    uint64_t odd = 0;
+    uint64_t touched = 0;
+    uint64_t merges = 0;
+    uint64_t edges = 0;
+
+    void touch(uint32_t v) {
+        if (v == UINT32_MAX) throw std::runtime_error("vertex ID out of range");
+        if (v >= vertices) {
+            vertices = v + 1;
+            components.resize(vertices);
+            odd_bits.resize((static_cast<size_t>(vertices) + 63) / 64, 0);
+            touched_bits.resize(odd_bits.size(), 0);
+        }
+        const uint64_t bit = uint64_t{1} << (v % 64);
+        touched += !(touched_bits[v / 64] & bit);
+        touched_bits[v / 64] |= bit;
+        odd_bits[v / 64] ^= bit;
+        if (odd_bits[v / 64] & bit) {
+            odd++;
+        } else {
+            odd--;
+        }
+    }
+
+public:
+    void add_edges(const std::pair<uint32_t, uint32_t>* batch, size_t count) {
+        for (size_t i = 0; i < count; i++) {
+            const auto [u, v] = batch[i];
+            touch(u);
+            touch(v);
+            merges += components.unite(u, v);
+        }
+        edges += count;
+    }
+
+    void add_edges(const std::vector<std::pair<uint32_t, uint32_t>>& batch) {add_edges(batch.data(), batch.size());}
+
+    uint64_t edge_count() const {return edges;}
+    uint64_t odd_degree_count() const {return odd;}
+    bool edges_connected() const {return touched - merges <= 1;}
+    std::string analyze_elerian() const {return describe_eulerian(odd, edges_connected());}
+};
+
 // Runs test cases to validate the graph logic
 void run_tests() {
     std::vector<std::pair<std::string, std::vector<std::pair<char, char>>>> test_cases = {
@@ -88,12 +585,263 @@ void run_tests() {
     for (const auto& [name, bridges] : test_cases) {
         std::cout << "Test Case: " << name << "\n";
         Graph graph(bridges);
-        std::cout << "Result: " << '\n' << graph.analyze_elerian() << "\n";
+        std::cout << graph.degree_report() << "Result: " << '\n' << graph.analyze_elerian() << "\n";
+    }
+
+    // Test: the CSR form keeps every bridge from both ends, duplicates included
+    Graph konigsberg(test_cases[0].second);
+    auto adjacency = konigsberg.get_adjacency_list();
+    assert(adjacency.size() == 4 && adjacency['A'].size() == 4 && adjacency['C'].size() == 3);
+    assert(std::count(adjacency['A'].begin(), adjacency['A'].end(), 'B') == 2);
+    assert(konigsberg.get_csr().edge_count() == 7 && konigsberg.get_csr().count_odd_degrees() == 2);
+
+    // Test: a self-loop adds two to its vertex's degree
+    Graph loop({{'A', 'A'}, {'A', 'B'}});
+    assert(loop.get_csr().degree(0) == 3 && loop.get_csr().count_odd_degrees() == 2);
+
+    // Test: the parallel odd-degree count matches a direct degree count on a random multigraph
+    std::mt19937 rng(1736);
+    const uint32_t vertices = 300000;
+    std::vector<std::pair<uint32_t, uint32_t>> edges(1000000);
+    std::vector<uint32_t> degrees(vertices, 0);
+    for (auto& [u, v] : edges) {
+        u = rng() % vertices;
+        v = rng() % vertices;
+        degrees[u]++;
+        degrees[v]++;
+    }
+    CsrGraph random_graph(vertices, edges);
+    uint64_t expected_odd = 0;
+    for (uint32_t v = 0; v < vertices; v++) {
+        assert(random_graph.degree(v) == degrees[v]);
+        expected_odd += degrees[v] & 1;
+    }
+    for (unsigned threads : {1u, 2u, 7u}) {
+        assert(random_graph.count_odd_degrees(threads) == expected_odd);
+    }
+    assert(CsrGraph().count_odd_degrees() == 0);
+
+    // Test: every route found uses each input edge exactly once and joins consecutive vertices
+    auto is_route = [](const std::vector<std::pair<uint32_t, uint32_t>>& list, const std::vector<uint32_t>& walk) {
+        if (walk.size() != list.size() + 1) return false;
+        std::vector<std::pair<uint32_t, uint32_t>> expected, walked;
+        for (auto [u, v] : list) expected.emplace_back(std::min(u, v), std::max(u, v));
+        for (size_t i = 0; i + 1 < walk.size(); i++) walked.emplace_back(std::min(walk[i], walk[i + 1]), std::max(walk[i], walk[i + 1]));
+        std::sort(expected.begin(), expected.end());
+        std::sort(walked.begin(), walked.end());
+        return expected == walked;
+    };
+    for (const auto& [name, bridges] : test_cases) {
+        Graph graph(bridges);
+        std::vector<char> route = graph.eulerian_route();
+        bool exists = graph.get_csr().count_odd_degrees() <= 2;
+        assert(route.size() == (exists ? bridges.size() + 1 : 0));
     }
+    std::vector<char> konigsberg_route = konigsberg.eulerian_route();
+    assert(konigsberg_route.front() == 'C' && konigsberg_route.back() == 'D');
+
+    // Test: all degrees even but two separate triangles is not a circuit
+    Graph split({{'A', 'B'}, {'B', 'C'}, {'C', 'A'}, {'D', 'E'}, {'E', 'F'}, {'F', 'D'}});
+    assert(split.get_csr().count_odd_degrees() == 0 && !split.get_csr().edges_connected());
+    assert(split.eulerian_route().empty() && split.analyze_elerian().find("connected") != std::string::npos);
+
+    // Test: isolated vertices are ignored, self-loops and parallel edges are walked once each
+    std::vector<std::pair<uint32_t, uint32_t>> multi = {{1, 2}, {2, 2}, {2, 1}, {1, 3}, {3, 1}, {1, 2}};
+    std::vector<uint32_t> multi_walk = CsrGraph(6, multi).eulerian_walk();
+    assert(is_route(multi, multi_walk) && multi_walk.front() == 1 && multi_walk.back() == 2);
+
+    // Test: a long random closed walk comes back as a circuit, a long line as a path
+    std::vector<std::pair<uint32_t, uint32_t>> closed;
+    uint32_t at = 0;
+    for (int i = 0; i < 199999; i++) {
+        uint32_t next = rng() % 1000;
+        closed.emplace_back(at, next);
+        at = next;
+    }
+    closed.emplace_back(at, 0);
+    std::vector<uint32_t> circuit = CsrGraph(1000, closed).eulerian_walk();
+    assert(is_route(closed, circuit) && circuit.front() == circuit.back());
+    std::vector<std::pair<uint32_t, uint32_t>> line;
+    for (uint32_t v = 0; v + 1 < 1000000; v++) line.emplace_back(v + 1, v);
+    std::vector<uint32_t> path = CsrGraph(1000000, line).eulerian_walk();
+    assert(is_route(line, path) && path.front() == 0 && path.back() == 999999);
+
+    // Test: text and binary edge files load the same edges, comments and CRLF included
+    {
+        std::string text_path = (std::filesystem::temp_directory_path() / "edges_test.txt").string();
+        std::string binary_path = (std::filesystem::temp_directory_path() / "edges_test.bin").string();
+        std::string text = "# Konigsberg\r\n% as ids\n0 1\r\n0\t1\n0 2 7.5\n  0 3\n2 1\n2,3\n1 3";
+        std::ofstream(text_path, std::ios::binary) << text;
+        std::vector<std::pair<uint32_t, uint32_t>> expected = {{0, 1}, {0, 1}, {0, 2}, {0, 3}, {2, 1}, {2, 3}, {1, 3}};
+        EdgeFile text_file = EdgeFile::open(text_path);
+        assert(!text_file.is_binary() && text_file.read_all(1) == expected && text_file.read_all(4) == expected);
+        assert(text_file.to_csr().analyze_elerian() == Graph(test_cases[0].second).analyze_elerian());
+
+        EdgeFile::write_binary(binary_path, closed);
+        EdgeFile binary_file = EdgeFile::open(binary_path);
+        assert(binary_file.is_binary() && binary_file.read_all() == closed);
+
+        // Small windows split the text between lines without losing or repeating an edge
+        std::vector<std::pair<uint32_t, uint32_t>> streamed;
+        text_file.for_each_batch([&streamed](const std::pair<uint32_t, uint32_t>* batch, size_t count) {
+            streamed.insert(streamed.end(), batch, batch + count);
+        }, 5, 2);
+        assert(streamed == expected);
+
+        std::ofstream(text_path, std::ios::binary) << "0 1\n2\n";
+        bool rejected = false;
+        try {
+            EdgeFile::open(text_path).read_all();
+        } catch (const std::runtime_error&) {
+            rejected = true;
+        }
+        assert(rejected);
+
+        // UINT32_MAX would wrap the vertex count, as text and as binary
+        std::ofstream(text_path, std::ios::binary) << "0 4294967295\n";
+        rejected = false;
+        try {
+            EdgeFile::open(text_path).read_all();
+        } catch (const std::runtime_error&) {
+            rejected = true;
+        }
+        assert(rejected);
+        EdgeFile::write_binary(binary_path, {{0, UINT32_MAX}});
+        rejected = false;
+        try {
+            EdgeFile::open(binary_path).to_csr();
+        } catch (const std::runtime_error&) {
+            rejected = true;
+        }
+        assert(rejected);
+
+        // An edge count that only matches the file size after wrapping around 2^64
+        {
+            std::ofstream out(binary_path, std::ios::binary);
+            edge_file_header header{};
+            std::memcpy(header.magic, "EDGES01", 8);
+            header.edge_count = (uint64_t{1} << 61) + 1;
+            const uint32_t edge[2] = {0, 1};
+            out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+            out.write(reinterpret_cast<const char*>(edge), sizeof(edge));
+        }
+        rejected = false;
+        try {
+            EdgeFile::open(binary_path);
+        } catch (const std::runtime_error&) {
+            rejected = true;
+        }
+        assert(rejected);
+        std::filesystem::remove(text_path);
+        std::filesystem::remove(binary_path);
+    }
+
+    // Test: the incremental status agrees with a full rebuild after every batch
+    {
+        IncrementalEuler incremental;
+        assert(incremental.edges_connected() && incremental.odd_degree_count() == 0);
+        std::vector<std::pair<uint32_t, uint32_t>> prefix;
+        for (size_t first = 0; first < 5000; first += 250) {
+            std::vector<std::pair<uint32_t, uint32_t>> batch;
+            for (int i = 0; i < 250; i++) batch.emplace_back(rng() % 3000, rng() % 3000);
+            incremental.add_edges(batch);
+            prefix.insert(prefix.end(), batch.begin(), batch.end());
+            CsrGraph rebuilt(3000, prefix);
+            assert(incremental.odd_degree_count() == rebuilt.count_odd_degrees());
+            assert(incremental.edges_connected() == rebuilt.edges_connected());
+        }
+        IncrementalEuler walk;
+        for (size_t first = 0; first < closed.size(); first += 1000) {
+            walk.add_edges(closed.data() + first, std::min<size_t>(1000, closed.size() - first));
+        }
+        assert(walk.edge_count() == closed.size() && walk.analyze_elerian() == describe_eulerian(0, true));
+    }
+    std::cout << "All tests passed\n";
 }
 
-int main() {
+// CSR build, odd-degree reduction, Hierholzer and edge file ingest on random multigraphs of 10^7 edges
+void run_benchmarks() {
+    const uint32_t vertices = 1000000;
+    std::mt19937 rng(1736);
+    std::vector<std::pair<uint32_t, uint32_t>> edges(10000000);
+    for (auto& [u, v] : edges) {
+        u = rng() % vertices;
+        v = rng() % vertices;
+    }
+    auto start = std::chrono::steady_clock::now();
+    CsrGraph graph(vertices, edges);
+    std::chrono::duration<double> built = std::chrono::steady_clock::now() - start;
+    std::cout << "CSR build, " << edges.size() << " edges: " << built.count() * 1000 << " ms\n";
+
+    unsigned max_threads = std::max(std::thread::hardware_concurrency(), 1u);
+    for (unsigned threads = 1; threads <= max_threads; threads *= 2) {
+        start = std::chrono::steady_clock::now();
+        uint64_t odd = graph.count_odd_degrees(threads);
+        std::chrono::duration<double> counted = std::chrono::steady_clock::now() - start;
+        std::cout << "  odd degrees with " << threads << " thread(s): " << odd << " in "
+                  << counted.count() * 1000 << " ms\n";
+    }
+
+    // A random closed walk, so the route exists and touches every edge
+    uint32_t at = 0;
+    for (size_t i = 0; i + 1 < edges.size(); i++) {
+        uint32_t next = rng() % vertices;
+        edges[i] = {at, next};
+        at = next;
+    }
+    edges.back() = {at, 0};
+    CsrGraph walkable(vertices, edges);
+    start = std::chrono::steady_clock::now();
+    bool connected = walkable.edges_connected();
+    std::chrono::duration<double> checked = std::chrono::steady_clock::now() - start;
+    start = std::chrono::steady_clock::now();
+    std::vector<uint32_t> route = walkable.eulerian_walk();
+    std::chrono::duration<double> walked = std::chrono::steady_clock::now() - start;
+    std::cout << "Connectivity (" << (connected ? "connected" : "split") << "): " << checked.count() * 1000
+              << " ms, Eulerian circuit of " << route.size() - 1 << " edges: " << walked.count() * 1000 << " ms\n";
+
+    // Same walk written as text and binary edge files, then loaded into CSR and streamed
+    // through the incremental status in 1M-edge batches
+    std::string text_path = (std::filesystem::temp_directory_path() / "edges_bench.txt").string();
+    std::string binary_path = (std::filesystem::temp_directory_path() / "edges_bench.bin").string();
+    {
+        std::string text;
+        for (const auto& [u, v] : edges) {
+            text += std::to_string(u);
+            text += ' ';
+            text += std::to_string(v);
+            text += '\n';
+        }
+        std::ofstream(text_path, std::ios::binary) << text;
+        EdgeFile::write_binary(binary_path, edges);
+    }
+    for (const std::string& path : {text_path, binary_path}) {
+        start = std::chrono::steady_clock::now();
+        EdgeFile file = EdgeFile::open(path);
+        CsrGraph loaded = file.to_csr(max_threads);
+        std::chrono::duration<double> loaded_in = std::chrono::steady_clock::now() - start;
+        start = std::chrono::steady_clock::now();
+        IncrementalEuler incremental;
+        file.for_each_batch([&incremental](const std::pair<uint32_t, uint32_t>* batch, size_t count) {
+            incremental.add_edges(batch, count);
+        }, size_t{1} << 23, max_threads);
+        std::chrono::duration<double> streamed = std::chrono::steady_clock::now() - start;
+        std::cout << (file.is_binary() ? "Binary" : "Text") << " edge file, " << file.bytes() / 1e6 << " MB: CSR load "
+                  << loaded_in.count() * 1000 << " ms (" << file.bytes() / 1e6 / loaded_in.count() << " MB/s), incremental "
+                  << streamed.count() * 1000 << " ms (" << file.bytes() / 1e6 / streamed.count() << " MB/s, "
+                  << incremental.analyze_elerian() << ")" << (loaded.edge_count() == edges.size() ? "" : " MISMATCH") << "\n";
+    }
+    std::filesystem::remove(text_path);
+    std::filesystem::remove(binary_path);
+}
+
+int main(int argc, char* argv[]) {
     std::cout << "Analyzing the Bridges of Konigsberg problem..\n";
     run_tests();
+
+    // pass --bench to time the CSR build, the odd-degree count, the route and edge file loading on a large graph
+    if (argc > 1 && std::string(argv[1]) == "--bench") {
+        run_benchmarks();
+    }
     return 0;
 }
\ No newline at end of file
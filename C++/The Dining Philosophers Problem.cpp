@@ -35,76 +35,886 @@ not much to say, alot of includes is funni
 #include <cassert>
 #include <vector>
 #include <functional>
+#include <memory>
+#include <condition_variable>
+#include <fstream>
+#include <cstring>
+#include <stdexcept>
+#include <filesystem>
+#include <numeric>
+#include <queue>
+#include <deque>
+#include <cstdint>
+#include <cmath>
+#if __has_include(<version>)
+#include <version>
+#endif
+#if defined(__cpp_lib_coroutine)
+#include <coroutine>
+#endif
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#include <immintrin.h>
+#endif
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+enum class philosopher_state : uint32_t {
+    Thinking = 0,
+    Hungry = 1,
+    GotFirstChopstick = 2,
+    Eating = 3,
+};
+
+inline const char* state_name(philosopher_state state) {
+    switch (state) {
+        case philosopher_state::Thinking: return "Thinking";
+        case philosopher_state::Hungry: return "Hungry";
+        case philosopher_state::GotFirstChopstick: return "Got first chopstick";
+        case philosopher_state::Eating: return "Eating";
+    }
+    return "?";
+}
+
+// Trace timestamps: the TSC on x86 (one instruction, no syscall), steady_clock nanoseconds
+// elsewhere. EventTracer measures the tick rate against steady_clock over the traced run.
+inline uint64_t trace_ticks() {
+#if defined(__x86_64__) || defined(_M_X64)
+    return __rdtsc();
+#else
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+#endif
+}
+
+struct trace_event {
+    uint64_t timestamp;         // trace_ticks()
+    uint32_t philosopher;
+    uint32_t state;             // philosopher_state
+};
+
+// Trace file: this header, then `events` trace_event records in native byte order. Records of
+// one philosopher appear in time order, records of different philosophers are interleaved.
+struct trace_file_header {
+    char magic[8];              // "PHTRACE"
+    uint32_t version;
+    uint32_t philosophers;
+    uint64_t ticks_per_second;
+    uint64_t events;
+    uint64_t dropped;           // events lost to full rings
+};
+
+// Single-producer single-consumer ring of trace events. The producer only writes head and the
+// consumer only writes tail, each on its own cache line, and the producer re-reads tail only
+// when its cached copy says the ring is full. A full ring drops the event rather than block.
+class SpscRing {
+private:
+    std::unique_ptr<trace_event[]> slots;
+    uint64_t mask;
+    alignas(64) std::atomic<uint64_t> head{0};
+    uint64_t cached_tail = 0;
+    uint64_t dropped_events = 0;
+    alignas(64) std::atomic<uint64_t> tail{0};
+
+public:
+    explicit SpscRing(size_t capacity = 4096) {
+        size_t size = 1;
+        while (size < capacity) size <<= 1;
+        slots.reset(new trace_event[size]);
+        mask = size - 1;
+    }
+
+    bool push(const trace_event& event) {
+        const uint64_t position = head.load(std::memory_order_relaxed);
+        if (position - cached_tail > mask) {
+            cached_tail = tail.load(std::memory_order_acquire);
+            if (position - cached_tail > mask) {
+                dropped_events++;
+                return false;
+            }
+        }
+        slots[position & mask] = event;
+        head.store(position + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Consumer side: moves up to max events into out
+    size_t pop(trace_event* out, size_t max) {
+        const uint64_t position = tail.load(std::memory_order_relaxed);
+        const uint64_t available = std::min<uint64_t>(head.load(std::memory_order_acquire) - position, max);
+        for (uint64_t i = 0; i < available; i++) out[i] = slots[(position + i) & mask];
+        tail.store(position + available, std::memory_order_release);
+        return static_cast<size_t>(available);
+    }
+
+    // Read by the producer, or by anyone once the producer has stopped
+    uint64_t dropped() const {return dropped_events;}
+};
+
+// One SpscRing per philosopher thread and a background drainer that moves events to the trace
+// file in large batches. Recording is a TSC read and a store into the thread's own ring: no
+// lock, no shared cache line and no I/O on the philosopher's side.
+class EventTracer {
+private:
+    static constexpr size_t BATCH_EVENTS = 1 << 14;
+    std::string path;
+    std::vector<std::unique_ptr<SpscRing>> rings;
+    std::ofstream out;
+    std::thread drainer;
+    std::atomic<bool> running{false};
+    uint64_t written = 0;
+    uint64_t fixed_ticks_per_second;
+    uint64_t start_ticks = 0;
+    std::chrono::steady_clock::time_point start_time;
+
+    void write_header(uint64_t ticks_per_second, uint64_t dropped) {
+        trace_file_header header{};
+        std::memcpy(header.magic, "PHTRACE", 8);
+        header.version = 1;
+        header.philosophers = static_cast<uint32_t>(rings.size());
+        header.ticks_per_second = ticks_per_second;
+        header.events = written;
+        header.dropped = dropped;
+        out.seekp(0);
+        out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    }
+
+    // Empties every ring once; returns the number of events written
+    size_t drain_once(std::vector<trace_event>& batch) {
+        size_t moved = 0;
+        for (auto& ring : rings) {
+            size_t count;
+            while ((count = ring->pop(batch.data(), batch.size())) != 0) {
+                out.write(reinterpret_cast<const char*>(batch.data()), static_cast<std::streamsize>(count * sizeof(trace_event)));
+                moved += count;
+            }
+        }
+        written += moved;
+        return moved;
+    }
+
+    void drain() {
+        std::vector<trace_event> batch(BATCH_EVENTS);
+        while (running.load(std::memory_order_acquire)) {
+            if (drain_once(batch) == 0) std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        drain_once(batch);
+    }
+
+public:
+    // ticks_per_second fixes the timestamp unit (1000 for virtual milliseconds); 0 measures the TSC
+    EventTracer(const std::string& path, int philosophers, size_t ring_capacity = 1 << 14, uint64_t ticks_per_second = 0)
+        : path(path), out(path, std::ios::binary | std::ios::trunc), fixed_ticks_per_second(ticks_per_second) {
+        if (!out) throw std::runtime_error("cannot write trace " + path);
+        for (int i = 0; i < philosophers; i++) rings.push_back(std::make_unique<SpscRing>(ring_capacity));
+        write_header(0, 0);
+        start_ticks = trace_ticks();
+        start_time = std::chrono::steady_clock::now();
+        running = true;
+        drainer = std::thread(&EventTracer::drain, this);
+    }
+
+    EventTracer(const EventTracer&) = delete;
+    EventTracer& operator=(const EventTracer&) = delete;
+    ~EventTracer() { close(); }
+
+    // Called only from the thread that runs this philosopher
+    void record(int philosopher, philosopher_state state, uint64_t timestamp = trace_ticks()) {
+        rings[philosopher]->push({timestamp, static_cast<uint32_t>(philosopher), static_cast<uint32_t>(state)});
+    }
+
+    // Flushes everything and finishes the header; call after the philosopher threads have stopped
+    void close() {
+        if (!running.exchange(false)) return;
+        drainer.join();
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start_time).count();
+        uint64_t ticks_per_second = fixed_ticks_per_second ? fixed_ticks_per_second
+                                  : seconds > 0 ? static_cast<uint64_t>((trace_ticks() - start_ticks) / seconds) : 1;
+        uint64_t dropped = 0;
+        for (auto& ring : rings) dropped += ring->dropped();
+        write_header(std::max<uint64_t>(ticks_per_second, 1), dropped);
+        out.close();
+    }
+
+    uint64_t events_written() const {return written;}
+};
+
+// Reads a trace file back for the --report tool: per-philosopher state timelines and
+// histograms of the time from Hungry to Eating
+class TraceReport {
+private:
+    trace_file_header header{};
+    std::vector<std::vector<trace_event>> by_philosopher;
+    uint64_t first = UINT64_MAX, last = 0;
+
+public:
+    static constexpr int HISTOGRAM_BUCKETS = 24;  // bucket b holds waits in [2^b, 2^(b+1)) microseconds
+
+    explicit TraceReport(const std::string& path) {
+        std::ifstream in(path, std::ios::binary);
+        in.read(reinterpret_cast<char*>(&header), sizeof(header));
+        if (!in || std::memcmp(header.magic, "PHTRACE", 8) != 0 || header.version != 1) {
+            throw std::runtime_error("not a philosopher trace: " + path);
+        }
+        std::vector<trace_event> events(header.events);
+        in.read(reinterpret_cast<char*>(events.data()), static_cast<std::streamsize>(events.size() * sizeof(trace_event)));
+        if (!in) throw std::runtime_error("truncated trace: " + path);
+        by_philosopher.resize(header.philosophers);
+        for (const trace_event& event : events) {
+            if (event.philosopher >= header.philosophers) throw std::runtime_error("corrupt trace: " + path);
+            by_philosopher[event.philosopher].push_back(event);
+            first = std::min(first, event.timestamp);
+            last = std::max(last, event.timestamp);
+        }
+    }
+
+    const trace_file_header& get_header() const {return header;}
+    const std::vector<trace_event>& events_of(int philosopher) const {return by_philosopher[philosopher];}
+
+    // One row per philosopher, one column per slice of the run, showing the state at the
+    // start of the slice: '.' thinking, 'h' hungry, '1' one chopstick, 'E' eating
+    std::string render_timeline(int width = 100) const {
+        static const char symbols[] = {'.', 'h', '1', 'E'};
+        std::string text;
+        const double span = first < last ? static_cast<double>(last - first) : 1;
+        for (size_t id = 0; id < by_philosopher.size(); id++) {
+            text += "P" + std::to_string(id) + (id < 10 ? "  |" : " |");
+            const auto& events = by_philosopher[id];
+            size_t next = 0;
+            uint32_t state = 0;
+            for (int column = 0; column < width; column++) {
+                uint64_t at = first + static_cast<uint64_t>(span * column / width);
+                while (next < events.size() && events[next].timestamp <= at) state = events[next++].state;
+                text += symbols[state & 3];
+            }
+            text += "|\n";
+        }
+        return text;
+    }
+
+    // Per philosopher, how many Hungry -> Eating waits fell into each power-of-two microsecond bucket
+    std::vector<std::vector<uint64_t>> wait_histograms() const {
+        std::vector<std::vector<uint64_t>> histograms(by_philosopher.size(), std::vector<uint64_t>(HISTOGRAM_BUCKETS, 0));
+        const double ticks_per_us = header.ticks_per_second / 1e6;
+        for (size_t id = 0; id < by_philosopher.size(); id++) {
+            uint64_t hungry_since = 0;
+            bool hungry = false;
+            for (const trace_event& event : by_philosopher[id]) {
+                auto state = static_cast<philosopher_state>(event.state);
+                if (state == philosopher_state::Hungry) {
+                    hungry_since = event.timestamp;
+                    hungry = true;
+                } else if (state == philosopher_state::Eating && hungry) {
+                    uint64_t us = static_cast<uint64_t>((event.timestamp - hungry_since) / ticks_per_us);
+                    int bucket = 0;
+                    while (bucket + 1 < HISTOGRAM_BUCKETS && (uint64_t{2} << bucket) <= us) bucket++;
+                    histograms[id][bucket]++;
+                    hungry = false;
+                }
+            }
+        }
+        return histograms;
+    }
+
+    void print(std::ostream& os, int width = 100) const {
+        os << header.events << " events from " << header.philosophers << " philosophers over "
+           << (last > first ? (last - first) / static_cast<double>(header.ticks_per_second) : 0) << " s ("
+           << header.dropped << " dropped)\n" << render_timeline(width) << "\nWait from Hungry to Eating (microseconds):\n";
+        auto histograms = wait_histograms();
+        for (size_t id = 0; id < histograms.size(); id++) {
+            os << "P" << id << ":";
+            for (int bucket = 0; bucket < HISTOGRAM_BUCKETS; bucket++) {
+                if (histograms[id][bucket]) os << " [" << (bucket ? uint64_t{1} << bucket : 0) << ", " << (uint64_t{2} << bucket) << "): " << histograms[id][bucket];
+            }
+            os << "\n";
+        }
+    }
+};
+
+// Per-philosopher random stream, so a seed fixes every think and eat time regardless of how
+// the threads interleave. rng() % 1000 rather than a distribution keeps the sequence the same
+// on every standard library.
+inline std::mt19937 philosopher_rng(uint64_t seed, int philosopher_id) {
+    return std::mt19937(static_cast<uint32_t>(seed ^ (seed >> 32) ^ (0x9E3779B9u * static_cast<uint32_t>(philosopher_id + 1))));
+}
+
+inline std::chrono::milliseconds random_duration(std::mt19937& rng) {
+    return std::chrono::milliseconds(rng() % 1000 + 500);
+}
+
+struct simulation_aborted {};
+
+// Discrete-event scheduler that runs real threads in lock-step on a virtual clock. Exactly one
+// thread runs at a time; sleep_for files a wake-up event and hands over to the earliest event
+// (ties in the order they were filed), and lock/unlock are FIFO mutexes that hand ownership
+// straight to the next waiter. Runs are fully reproducible, take no real time to sleep, and a
+// state where every live thread waits on a mutex is reported as a deadlock instead of hanging.
+class VirtualScheduler {
+private:
+    struct ready_entry {
+        int64_t time;
+        uint64_t sequence;
+        int thread;
+        bool operator>(const ready_entry& other) const {
+            return time != other.time ? time > other.time : sequence > other.sequence;
+        }
+    };
+
+    std::mutex state_mutex;
+    std::vector<std::unique_ptr<std::condition_variable>> wakeups;
+    std::condition_variable finished;
+    std::priority_queue<ready_entry, std::vector<ready_entry>, std::greater<ready_entry>> ready;
+    std::vector<int> owners;
+    std::vector<std::deque<int>> waiters;
+    int64_t now_ms = 0;
+    uint64_t sequence = 0;
+    int current = -1;
+    int live = 0;
+    bool aborted = false;
+
+    // Called with state_mutex held by the thread giving up its turn
+    void dispatch_next() {
+        if (ready.empty()) {
+            if (live > 0) {
+                aborted = true;
+                for (auto& wakeup : wakeups) wakeup->notify_one();
+            }
+            current = -1;
+            finished.notify_all();
+            return;
+        }
+        ready_entry next = ready.top();
+        ready.pop();
+        now_ms = next.time;
+        current = next.thread;
+        wakeups[next.thread]->notify_one();
+    }
+
+    void wait_turn(std::unique_lock<std::mutex>& lock, int thread) {
+        wakeups[thread]->wait(lock, [&] {return current == thread || aborted;});
+        if (aborted) throw simulation_aborted{};
+    }
+
+public:
+    explicit VirtualScheduler(int mutexes = 0) : owners(mutexes, -1), waiters(mutexes) {}
+
+    // Runs body(id) for ids 0 .. threads - 1 until all return; false if they deadlocked
+    bool run(int threads, const std::function<void(int)>& body) {
+        std::vector<std::thread> pool;
+        {
+            std::lock_guard<std::mutex> lock(state_mutex);
+            wakeups.clear();
+            ready = {};
+            std::fill(owners.begin(), owners.end(), -1);
+            for (auto& queue : waiters) queue.clear();
+            for (int id = 0; id < threads; id++) {
+                wakeups.push_back(std::make_unique<std::condition_variable>());
+                ready.push({now_ms, sequence++, id});
+            }
+            live = threads;
+            aborted = false;
+        }
+        for (int id = 0; id < threads; id++) {
+            pool.emplace_back([this, id, &body] {
+                try {
+                    {
+                        std::unique_lock<std::mutex> lock(state_mutex);
+                        wait_turn(lock, id);
+                    }
+                    body(id);
+                } catch (const simulation_aborted&) {
+                    return;
+                }
+                std::lock_guard<std::mutex> lock(state_mutex);
+                live--;
+                dispatch_next();
+            });
+        }
+        {
+            std::unique_lock<std::mutex> lock(state_mutex);
+            dispatch_next();
+            finished.wait(lock, [this] {return current == -1 && (live == 0 || aborted);});
+        }
+        for (auto& thread : pool) thread.join();
+        return !aborted;
+    }
+
+    std::chrono::milliseconds now() const {return std::chrono::milliseconds(now_ms);}
+
+    void sleep_for(int thread, std::chrono::milliseconds duration) {
+        std::unique_lock<std::mutex> lock(state_mutex);
+        ready.push({now_ms + duration.count(), sequence++, thread});
+        dispatch_next();
+        wait_turn(lock, thread);
+    }
+
+    void lock(int thread, int mutex) {
+        std::unique_lock<std::mutex> lock(state_mutex);
+        if (owners[mutex] == -1) {
+            owners[mutex] = thread;
+            return;
+        }
+        waiters[mutex].push_back(thread);
+        dispatch_next();
+        wait_turn(lock, thread);
+    }
+
+    void unlock(int thread, int mutex) {
+        std::lock_guard<std::mutex> lock(state_mutex);
+        assert(owners[mutex] == thread);
+        (void)thread;
+        if (waiters[mutex].empty()) {
+            owners[mutex] = -1;
+            return;
+        }
+        owners[mutex] = waiters[mutex].front();
+        waiters[mutex].pop_front();
+        ready.push({now_ms, sequence++, owners[mutex]});
+    }
+};
+
+struct dinner_statistics {
+    std::vector<int> eat_counts;
+    std::vector<std::chrono::milliseconds> wait_times;
+    int max_concurrent_eating = 0;
+    bool deadlocked = false;
+};
+
+// The same dinner as DiningPhilosophers on a VirtualScheduler, but as a single-threaded event
+// loop: every philosopher is a small state machine resumed by its next event. It files events
+// and draws random numbers in exactly the order the lock-step threads do, so for a given seed
+// both produce identical statistics; this one just needs no threads at all.
+class DinnerSimulation {
+private:
+    enum class phase { Start, Thought, GotFirst, GotSecond, Ate };
+
+public:
+    static dinner_statistics run(uint64_t seed, std::chrono::milliseconds duration, int philosophers = 5) {
+        struct event {
+            int64_t time;
+            uint64_t sequence;
+            int philosopher;
+            bool operator>(const event& other) const {
+                return time != other.time ? time > other.time : sequence > other.sequence;
+            }
+        };
+        std::priority_queue<event, std::vector<event>, std::greater<event>> events;
+        std::vector<int> owners(philosophers, -1);
+        std::vector<std::deque<int>> waiters(philosophers);
+        std::vector<phase> phases(philosophers, phase::Start);
+        std::vector<int64_t> hungry_since(philosophers, 0);
+        std::vector<std::mt19937> rngs;
+        uint64_t sequence = 0;
+        int64_t now = 0;
+        int eating = 0, live = philosophers;
+
+        dinner_statistics stats;
+        stats.eat_counts.assign(philosophers, 0);
+        stats.wait_times.assign(philosophers, std::chrono::milliseconds(0));
+        for (int id = 0; id < philosophers; id++) {
+            rngs.push_back(philosopher_rng(seed, id));
+            events.push({0, sequence++, id});
+        }
+
+        // true when the chopstick is ours now, otherwise we are queued for it
+        auto take = [&](int chopstick, int id) {
+            if (owners[chopstick] == -1) {
+                owners[chopstick] = id;
+                return true;
+            }
+            waiters[chopstick].push_back(id);
+            return false;
+        };
+        auto put_down = [&](int chopstick) {
+            if (waiters[chopstick].empty()) {
+                owners[chopstick] = -1;
+                return;
+            }
+            owners[chopstick] = waiters[chopstick].front();
+            waiters[chopstick].pop_front();
+            events.push({now, sequence++, owners[chopstick]});
+        };
+
+        while (!events.empty()) {
+            const event next = events.top();
+            events.pop();
+            now = next.time;
+            const int id = next.philosopher;
+            const int first = std::min(id, (id + 1) % philosophers);
+            const int second = std::max(id, (id + 1) % philosophers);
+            switch (phases[id]) {
+                case phase::Ate:
+                    eating--;
+                    put_down(second);
+                    put_down(first);
+                    [[fallthrough]];
+                case phase::Start:
+                    if (now >= duration.count()) {
+                        live--;
+                        break;
+                    }
+                    events.push({now + random_duration(rngs[id]).count(), sequence++, id});
+                    phases[id] = phase::Thought;
+                    break;
+                case phase::Thought:
+                    hungry_since[id] = now;
+                    phases[id] = phase::GotFirst;
+                    if (!take(first, id)) break;
+                    [[fallthrough]];
+                case phase::GotFirst:
+                    phases[id] = phase::GotSecond;
+                    if (!take(second, id)) break;
+                    [[fallthrough]];
+                case phase::GotSecond:
+                    stats.wait_times[id] += std::chrono::milliseconds(now - hungry_since[id]);
+                    stats.eat_counts[id]++;
+                    stats.max_concurrent_eating = std::max(stats.max_concurrent_eating, ++eating);
+                    events.push({now + random_duration(rngs[id]).count(), sequence++, id});
+                    phases[id] = phase::Ate;
+                    break;
+            }
+        }
+        stats.deadlocked = live > 0;
+        return stats;
+    }
+};
+
+// HDR-style latency histogram in nanoseconds: exact below 32 ns, then 32 buckets per power of
+// two, so a reported value is never more than 1/32 above the real one. Values past 2^41 ns
+// (about 36 minutes) land in the last bucket. Only the owning thread records, with relaxed
+// loads and stores instead of read-modify-writes; readers may copy it at any time and see
+// at worst a few samples late.
+class LatencyHistogram {
+public:
+    static constexpr int SUB_BITS = 5;
+    static constexpr int MAX_MAGNITUDE = 40;
+    static constexpr size_t BUCKETS = size_t{MAX_MAGNITUDE - SUB_BITS + 2} << SUB_BITS;
+
+private:
+    std::array<std::atomic<uint64_t>, BUCKETS> counts{};
+    std::atomic<uint64_t> maximum{0};
+
+    static int highest_bit(uint64_t x) {
+#if defined(_MSC_VER)
+        unsigned long index;
+        _BitScanReverse64(&index, x);
+        return static_cast<int>(index);
+#else
+        return 63 - __builtin_clzll(x);
+#endif
+    }
+
+public:
+    static size_t bucket_of(uint64_t nanoseconds) {
+        if (nanoseconds < (1u << SUB_BITS)) return static_cast<size_t>(nanoseconds);
+        int magnitude = highest_bit(nanoseconds);
+        if (magnitude > MAX_MAGNITUDE) {
+            magnitude = MAX_MAGNITUDE;
+            nanoseconds = (uint64_t{2} << MAX_MAGNITUDE) - 1;
+        }
+        uint64_t mantissa = (nanoseconds >> (magnitude - SUB_BITS)) - (1u << SUB_BITS);
+        return (static_cast<size_t>(magnitude - SUB_BITS + 1) << SUB_BITS) + static_cast<size_t>(mantissa);
+    }
+
+    // Largest value that falls in bucket
+    static uint64_t bucket_limit(size_t bucket) {
+        if (bucket < (1u << SUB_BITS)) return bucket;
+        int magnitude = static_cast<int>(bucket >> SUB_BITS) + SUB_BITS - 1;
+        uint64_t mantissa = (1u << SUB_BITS) + (bucket & ((1u << SUB_BITS) - 1));
+        return ((mantissa + 1) << (magnitude - SUB_BITS)) - 1;
+    }
+
+    void record(std::chrono::nanoseconds latency) {
+        uint64_t value = static_cast<uint64_t>(std::max<int64_t>(latency.count(), 0));
+        std::atomic<uint64_t>& count = counts[bucket_of(value)];
+        count.store(count.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        if (value > maximum.load(std::memory_order_relaxed)) maximum.store(value, std::memory_order_relaxed);
+    }
+
+    // Adds this histogram's counts into merged, which must hold BUCKETS entries
+    void add_to(std::vector<uint64_t>& merged, uint64_t& merged_maximum) const {
+        for (size_t bucket = 0; bucket < BUCKETS; bucket++) merged[bucket] += counts[bucket].load(std::memory_order_relaxed);
+        merged_maximum = std::max(merged_maximum, maximum.load(std::memory_order_relaxed));
+    }
+
+    void reset() {
+        for (auto& count : counts) count.store(0, std::memory_order_relaxed);
+        maximum.store(0, std::memory_order_relaxed);
+    }
+};
+
+// Percentiles of one kind of latency over every philosopher, in nanoseconds
+struct latency_summary {
+    uint64_t count = 0;
+    uint64_t p50 = 0, p99 = 0, p999 = 0, max = 0;
+};
+
+struct contention_summary {
+    latency_summary acquire;        // one chopstick (or one strategy acquire) from asking to holding
+    latency_summary hold;           // from the first bite to putting both chopsticks down
+    latency_summary think_to_eat;   // from the end of thinking to the first bite
+    uint64_t meals = 0;
+    // Same meaning for every strategy: a failure is one try for one chopstick that found it held
+    // by a neighbour or lost it to one, a spin is one busy-wait step (a spin_wait round or a
+    // backoff pause) while acquiring. Blocking in a mutex is neither, and a strategy whose
+    // philosophers never touch a chopstick themselves (the waiter) has no failures.
+    uint64_t failures = 0;
+    uint64_t spins = 0;
+    double fairness = 0;            // Jain's index over meals: 1 when everyone ate equally, 1/n when one did
+};
+
+// Jain's fairness index, (sum x)^2 / (n * sum x^2)
+inline double jain_fairness(const std::vector<uint64_t>& shares) {
+    double sum = 0, squares = 0;
+    for (uint64_t share : shares) {
+        sum += static_cast<double>(share);
+        squares += static_cast<double>(share) * static_cast<double>(share);
+    }
+    return squares > 0 ? sum * sum / (static_cast<double>(shares.size()) * squares) : 1.0;
+}
+
+// Contention and latency counters for a table. Every philosopher gets its own cache-line
+// aligned slot and only that philosopher's thread writes it, so recording takes no lock and
+// no read-modify-write. summary() and the getters read all slots whenever asked, even while
+// the table is still running.
+class ContentionMetrics {
+private:
+    struct alignas(64) philosopher_slot {
+        LatencyHistogram acquire, hold, think_to_eat;
+        std::atomic<uint64_t> meals{0}, wait_ns{0}, failures{0}, spins{0};
+    };
+
+    int count;
+    std::unique_ptr<philosopher_slot[]> slots;
+
+    static void add(std::atomic<uint64_t>& counter, uint64_t amount) {
+        counter.store(counter.load(std::memory_order_relaxed) + amount, std::memory_order_relaxed);
+    }
+
+    static latency_summary summarize(const std::vector<uint64_t>& merged, uint64_t maximum) {
+        latency_summary summary;
+        summary.count = std::accumulate(merged.begin(), merged.end(), uint64_t{0});
+        summary.max = maximum;
+        if (summary.count == 0) return summary;
+        std::array<std::pair<double, uint64_t*>, 3> wanted{{{0.5, &summary.p50}, {0.99, &summary.p99}, {0.999, &summary.p999}}};
+        uint64_t seen = 0;
+        size_t next = 0;
+        for (size_t bucket = 0; bucket < merged.size() && next < wanted.size(); bucket++) {
+            seen += merged[bucket];
+            while (next < wanted.size() && seen >= std::ceil(wanted[next].first * summary.count)) {
+                *wanted[next++].second = std::min(LatencyHistogram::bucket_limit(bucket), maximum);
+            }
+        }
+        return summary;
+    }
+
+    latency_summary merge(LatencyHistogram philosopher_slot::*histogram) const {
+        std::vector<uint64_t> merged(LatencyHistogram::BUCKETS, 0);
+        uint64_t maximum = 0;
+        for (int id = 0; id < count; id++) (slots[id].*histogram).add_to(merged, maximum);
+        return summarize(merged, maximum);
+    }
+
+public:
+    explicit ContentionMetrics(int philosophers) : count(philosophers), slots(new philosopher_slot[philosophers]) {}
+
+    int philosopher_count() const {return count;}
+
+    // Hot path: each of these must come from philosopher id's own thread
+    void record_acquire(int id, std::chrono::nanoseconds latency) {slots[id].acquire.record(latency);}
+    void record_hold(int id, std::chrono::nanoseconds latency) {slots[id].hold.record(latency);}
+
+    void record_meal(int id, std::chrono::nanoseconds think_to_eat) {
+        slots[id].think_to_eat.record(think_to_eat);
+        add(slots[id].meals, 1);
+        add(slots[id].wait_ns, static_cast<uint64_t>(std::max<int64_t>(think_to_eat.count(), 0)));
+    }
+
+    void record_contention(int id, uint64_t failures, uint64_t spins) {
+        if (failures) add(slots[id].failures, failures);
+        if (spins) add(slots[id].spins, spins);
+    }
+
+    uint64_t meals(int id) const {return slots[id].meals.load(std::memory_order_relaxed);}
+
+    // Total time philosopher id spent between thinking and eating
+    std::chrono::nanoseconds wait_time(int id) const {
+        return std::chrono::nanoseconds(slots[id].wait_ns.load(std::memory_order_relaxed));
+    }
+
+    contention_summary summary() const {
+        contention_summary result;
+        result.acquire = merge(&philosopher_slot::acquire);
+        result.hold = merge(&philosopher_slot::hold);
+        result.think_to_eat = merge(&philosopher_slot::think_to_eat);
+        std::vector<uint64_t> meals_per_philosopher;
+        for (int id = 0; id < count; id++) {
+            meals_per_philosopher.push_back(meals(id));
+            result.failures += slots[id].failures.load(std::memory_order_relaxed);
+            result.spins += slots[id].spins.load(std::memory_order_relaxed);
+        }
+        result.meals = std::accumulate(meals_per_philosopher.begin(), meals_per_philosopher.end(), uint64_t{0});
+        result.fairness = jain_fairness(meals_per_philosopher);
+        return result;
+    }
+
+    // Not safe while philosophers are recording
+    void reset() {
+        for (int id = 0; id < count; id++) {
+            philosopher_slot& slot = slots[id];
+            slot.acquire.reset();
+            slot.hold.reset();
+            slot.think_to_eat.reset();
+            for (auto* counter : {&slot.meals, &slot.wait_ns, &slot.failures, &slot.spins}) counter->store(0);
+        }
+    }
+
+    void print(std::ostream& os) const {
+        contention_summary totals = summary();
+        auto line = [&os](const char* label, const latency_summary& latency) {
+            os << "  " << label << ": p50 " << latency.p50 << " ns, p99 " << latency.p99 << " ns, p999 "
+               << latency.p999 << " ns, max " << latency.max << " ns (" << latency.count << " samples)\n";
+        };
+        line("acquire", totals.acquire);
+        line("hold", totals.hold);
+        line("think to eat", totals.think_to_eat);
+        os << "  " << totals.meals << " meals, " << totals.failures << " failed attempts, " << totals.spins
+           << " spins, Jain fairness " << totals.fairness << "\n";
+    }
+};
 
 class DiningPhilosophers {
 private:
     static const int NUM_PHILOSOPHERS = 5;
     std::array<std::mutex, NUM_PHILOSOPHERS> chopsticks;
-    std::array<std::string, NUM_PHILOSOPHERS> philosopher_states;
-    std::mutex console_mutex;
+    std::array<std::atomic<philosopher_state>, NUM_PHILOSOPHERS> philosopher_states;
+    EventTracer* tracer = nullptr;
+    VirtualScheduler* scheduler = nullptr;  // virtual time when set, real threads and sleeps otherwise
+    std::chrono::milliseconds virtual_end{0};
     std::atomic<bool> simulation_running{true};
-    std::vector<int> eat_counts;  // Track how many times each philosopher eats
-    std::vector<std::chrono::milliseconds> wait_times;  // Track waiting times
+    std::vector<std::mt19937> rngs;
+    ContentionMetrics metrics{NUM_PHILOSOPHERS};  // meals, waits and latencies, written lock-free per philosopher
+    std::atomic<int> eating_now{0};
+    std::atomic<int> max_eating{0};
+
+    bool running() const {
+        return scheduler ? scheduler->now() < virtual_end : simulation_running.load();
+    }
+
+    std::chrono::nanoseconds elapsed() const {
+        return scheduler ? std::chrono::nanoseconds(scheduler->now()) : std::chrono::steady_clock::now().time_since_epoch();
+    }
+
+    void pause(int philosopher_id, std::chrono::milliseconds duration) {
+        if (scheduler) {
+            scheduler->sleep_for(philosopher_id, duration);
+        } else {
+            std::this_thread::sleep_for(duration);
+        }
+    }
+
+    void lock_chopstick(int philosopher_id, int chopstick) {
+        auto asked_at = elapsed();
+        if (scheduler) {
+            scheduler->lock(philosopher_id, chopstick);
+        } else if (!chopsticks[chopstick].try_lock()) {
+            metrics.record_contention(philosopher_id, 1, 0);
+            chopsticks[chopstick].lock();
+        }
+        metrics.record_acquire(philosopher_id, elapsed() - asked_at);
+    }
+
+    void unlock_chopstick(int philosopher_id, int chopstick) {
+        if (scheduler) {
+            scheduler->unlock(philosopher_id, chopstick);
+        } else {
+            chopsticks[chopstick].unlock();
+        }
+    }
 
 public:
-    DiningPhilosophers() : eat_counts(NUM_PHILOSOPHERS, 0), 
-                          wait_times(NUM_PHILOSOPHERS, std::chrono::milliseconds(0)) {
+    explicit DiningPhilosophers(uint64_t seed = std::random_device{}()) {
         for (int i = 0; i < NUM_PHILOSOPHERS; i++) {
-            philosopher_states[i] = "Thinking";
+            philosopher_states[i] = philosopher_state::Thinking;
+            rngs.push_back(philosopher_rng(seed, i));
         }
     }
 
-    void print_state(int philosopher_id, const std::string& state) {
-        std::lock_guard<std::mutex> console_lock(console_mutex);
-        philosopher_states[philosopher_id] = state;
-        
-        std::cout << "\nPhilosophers' states:\n";
+    // State changes go to the philosopher's own trace ring, never to the console
+    void set_state(int philosopher_id, philosopher_state state) {
+        philosopher_states[philosopher_id].store(state, std::memory_order_relaxed);
+        if (tracer) tracer->record(philosopher_id, state, scheduler ? static_cast<uint64_t>(scheduler->now().count()) : trace_ticks());
+    }
+
+    // Snapshot of the table, for printing outside the simulation
+    void print_state(std::ostream& os) const {
+        os << "\nPhilosophers' states:\n";
         for (int i = 0; i < NUM_PHILOSOPHERS; i++) {
-            std::cout << "Philosopher " << i << ": " << philosopher_states[i] 
-                     << " (Eaten: " << eat_counts[i] << " times)\n";
+            os << "Philosopher " << i << ": " << state_name(philosopher_states[i].load())
+               << " (Eaten: " << metrics.meals(i) << " times)\n";
         }
-        std::cout << "\n------------------------\n";
+        os << "\n------------------------\n";
     }
 
+    // Events of the next simulations go to tracer; it must outlive them
+    void attach_tracer(EventTracer* event_tracer) { tracer = event_tracer; }
+
+    // Runs the next simulations on virtual_time: durations become virtual, chopsticks become
+    // scheduler mutexes, and trace timestamps are virtual milliseconds
+    void attach_scheduler(VirtualScheduler* virtual_time) { scheduler = virtual_time; }
+    static int philosopher_count() { return NUM_PHILOSOPHERS; }
+
     void think(int philosopher_id) {
-        print_state(philosopher_id, "Thinking");
-        std::this_thread::sleep_for(std::chrono::milliseconds(rand() % 1000 + 500));
+        set_state(philosopher_id, philosopher_state::Thinking);
+        pause(philosopher_id, random_duration(rngs[philosopher_id]));
     }
 
     void eat(int philosopher_id) {
-        print_state(philosopher_id, "Eating");
-        eat_counts[philosopher_id]++;
-        std::this_thread::sleep_for(std::chrono::milliseconds(rand() % 1000 + 500));
+        set_state(philosopher_id, philosopher_state::Eating);
+        int eating = ++eating_now;
+        for (int seen = max_eating; seen < eating && !max_eating.compare_exchange_weak(seen, eating);) {}
+        pause(philosopher_id, random_duration(rngs[philosopher_id]));
+        eating_now--;
     }
 
     void philosopher(int philosopher_id) {
-        while (simulation_running) {
+        while (running()) {
             think(philosopher_id);
 
-            auto start_wait = std::chrono::steady_clock::now();
+            auto start_wait = elapsed();
             
             int first_chopstick = std::min(philosopher_id, (philosopher_id + 1) % NUM_PHILOSOPHERS);
             int second_chopstick = std::max(philosopher_id, (philosopher_id + 1) % NUM_PHILOSOPHERS);
 
-            print_state(philosopher_id, "Hungry");
+            set_state(philosopher_id, philosopher_state::Hungry);
 
-            chopsticks[first_chopstick].lock();
-            print_state(philosopher_id, "Got first chopstick");
+            lock_chopstick(philosopher_id, first_chopstick);
+            set_state(philosopher_id, philosopher_state::GotFirstChopstick);
 
-            chopsticks[second_chopstick].lock();
+            lock_chopstick(philosopher_id, second_chopstick);
             
-            auto end_wait = std::chrono::steady_clock::now();
-            wait_times[philosopher_id] += std::chrono::duration_cast<std::chrono::milliseconds>(
-                end_wait - start_wait);
+            auto end_wait = elapsed();
+            metrics.record_meal(philosopher_id, end_wait - start_wait);
             
             eat(philosopher_id);
 
-            chopsticks[second_chopstick].unlock();
-            chopsticks[first_chopstick].unlock();
+            unlock_chopstick(philosopher_id, second_chopstick);
+            unlock_chopstick(philosopher_id, first_chopstick);
+            metrics.record_hold(philosopher_id, elapsed() - end_wait);
         }
     }
 
     void start_simulation(int duration_seconds) {
+        start_simulation(std::chrono::milliseconds(std::chrono::seconds(duration_seconds)));
+    }
+
+    // With a scheduler attached this covers duration of virtual time and returns false if the
+    // philosophers deadlocked; otherwise it runs in real time and always returns true
+    bool start_simulation(std::chrono::milliseconds duration) {
+        if (scheduler) {
+            virtual_end = scheduler->now() + duration;
+            return scheduler->run(NUM_PHILOSOPHERS, [this](int id) {philosopher(id);});
+        }
         simulation_running = true;
         std::array<std::thread, NUM_PHILOSOPHERS> philosophers;
         
@@ -112,7 +922,7 @@ public:
             philosophers[i] = std::thread(&DiningPhilosophers::philosopher, this, i);
         }
 
-        std::this_thread::sleep_for(std::chrono::seconds(duration_seconds));
+        std::this_thread::sleep_for(duration);
         
         simulation_running = false;
         
@@ -121,17 +931,778 @@ public:
                 phil.join();
             }
         }
+        return true;
     }
 
     // Test-specific methods
-    std::vector<int> get_eat_counts() const { return eat_counts; }
-    std::vector<std::chrono::milliseconds> get_wait_times() const { return wait_times; }
-    void reset_statistics() {
-        std::fill(eat_counts.begin(), eat_counts.end(), 0);
-        std::fill(wait_times.begin(), wait_times.end(), std::chrono::milliseconds(0));
+    std::vector<int> get_eat_counts() const {
+        std::vector<int> counts;
+        for (int i = 0; i < NUM_PHILOSOPHERS; i++) counts.push_back(static_cast<int>(metrics.meals(i)));
+        return counts;
     }
+    std::vector<std::chrono::milliseconds> get_wait_times() const {
+        std::vector<std::chrono::milliseconds> waits;
+        for (int i = 0; i < NUM_PHILOSOPHERS; i++) waits.push_back(std::chrono::duration_cast<std::chrono::milliseconds>(metrics.wait_time(i)));
+        return waits;
+    }
+    int get_max_concurrent_eating() const { return max_eating; }
+    const ContentionMetrics& get_metrics() const { return metrics; }
+    void reset_statistics() { metrics.reset(); }
+};
+
+// Busy-wait hint for spin loops: lets the sibling hyperthread run and saves power
+inline void cpu_relax() {
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+    _mm_pause();
+#elif defined(__aarch64__)
+    asm volatile("yield");
+#endif
+}
+
+// Spin a little, then give the core away, then sleep; philosophers can far outnumber cores
+inline void spin_wait(unsigned& spins) {
+    if (++spins < 64) {
+        cpu_relax();
+    } else if (spins < 1024) {
+        std::this_thread::yield();
+    } else {
+        std::this_thread::sleep_for(std::chrono::microseconds(50));
+    }
+}
+
+// Stand-in for thinking or eating that costs CPU time instead of sleeping
+inline void busy_work(unsigned iterations) {
+    volatile unsigned sink = 0;
+    for (unsigned i = 0; i < iterations; i++) sink = sink + i;
+}
+
+// Chopsticks and per-philosopher slots each get their own cache line, so neighbours
+// spinning on adjacent entries never invalidate each other's line
+struct alignas(64) padded_mutex {
+    std::mutex lock;
 };
 
+struct alignas(64) padded_atomic {
+    std::atomic<uint64_t> value{0};
+};
+
+struct alignas(64) padded_counter {
+    uint64_t value = 0;
+};
+
+// How philosophers get both of their chopsticks. Philosopher i uses chopsticks i and
+// (i + 1) % n; start sizes the table before any philosopher thread runs and stop is
+// called after all of them have finished.
+class ArbitrationStrategy {
+public:
+    virtual ~ArbitrationStrategy() = default;
+    virtual const char* name() const = 0;
+    virtual void start(int philosophers) = 0;
+    virtual void acquire(int philosopher) = 0;
+    virtual void release(int philosopher) = 0;
+    virtual void stop() {}
+
+    // While attached, each acquire reports its failed attempts and spins to contention
+    void attach_metrics(ContentionMetrics* contention) {metrics = contention;}
+
+protected:
+    ContentionMetrics* metrics = nullptr;
+
+    void report_contention(int philosopher, uint64_t failures, uint64_t spins) {
+        if (metrics) metrics->record_contention(philosopher, failures, spins);
+    }
+};
+
+// The original scheme: lock the lower-numbered chopstick first, so no cycle of waits can form
+class OrderedMutexStrategy : public ArbitrationStrategy {
+private:
+    int count = 0;
+    std::unique_ptr<padded_mutex[]> chopsticks;
+
+public:
+    const char* name() const override {return "ordered mutexes";}
+
+    void start(int philosophers) override {
+        count = philosophers;
+        chopsticks.reset(new padded_mutex[philosophers]);
+    }
+
+    void acquire(int philosopher) override {
+        int right = (philosopher + 1) % count;
+        uint64_t failures = 0;
+        for (int chopstick : {std::min(philosopher, right), std::max(philosopher, right)}) {
+            if (!chopsticks[chopstick].lock.try_lock()) {
+                failures++;
+                chopsticks[chopstick].lock.lock();
+            }
+        }
+        report_contention(philosopher, failures, 0);
+    }
+
+    void release(int philosopher) override {
+        int right = (philosopher + 1) % count;
+        chopsticks[std::max(philosopher, right)].lock.unlock();
+        chopsticks[std::min(philosopher, right)].lock.unlock();
+    }
+};
+
+// Take the first chopstick, try the second, and on failure put both down and back off for a
+// random time that doubles with every failed attempt up to a cap
+class BackoffStrategy : public ArbitrationStrategy {
+private:
+    static constexpr unsigned MAX_BACKOFF_SPINS = 1 << 12;
+    int count = 0;
+    std::unique_ptr<padded_mutex[]> chopsticks;
+
+public:
+    const char* name() const override {return "try-lock with backoff";}
+
+    void start(int philosophers) override {
+        count = philosophers;
+        chopsticks.reset(new padded_mutex[philosophers]);
+    }
+
+    void acquire(int philosopher) override {
+        std::mutex& first = chopsticks[philosopher].lock;
+        std::mutex& second = chopsticks[(philosopher + 1) % count].lock;
+        uint32_t random = 2654435761u * static_cast<uint32_t>(philosopher + 1);
+        uint64_t failures = 0, spins = 0;
+        for (unsigned limit = 16;; limit = std::min(limit * 2, MAX_BACKOFF_SPINS)) {
+            if (first.try_lock()) {
+                if (second.try_lock()) break;
+                first.unlock();
+            }
+            random ^= random << 13;
+            random ^= random >> 17;
+            random ^= random << 5;
+            failures++;
+            spins += random % limit;
+            for (unsigned spin = random % limit; spin > 0; spin--) cpu_relax();
+            std::this_thread::yield();
+        }
+        report_contention(philosopher, failures, spins);
+    }
+
+    void release(int philosopher) override {
+        chopsticks[(philosopher + 1) % count].lock.unlock();
+        chopsticks[philosopher].lock.unlock();
+    }
+};
+
+// Chandy-Misra hygienic forks, kept in one atomic word per fork: owner, dirty, requested and
+// in-use bits. A hungry philosopher takes a neighbour's dirty fork that is not in use (cleaning
+// it), otherwise leaves a request on it; clean forks are never given up, and a dirty fork with a
+// request on it is handed over clean as soon as its owner is not eating. Forks start dirty with
+// the lower-numbered neighbour, so the precedence graph is acyclic and nobody starves.
+class ChandyMisraStrategy : public ArbitrationStrategy {
+private:
+    static constexpr uint64_t IN_USE = 1, DIRTY = 2, REQUESTED = 4, OWNER_SHIFT = 3;
+    int count = 0;
+    std::unique_ptr<padded_atomic[]> forks;
+
+    static uint64_t owner(uint64_t state) {return state >> OWNER_SHIFT;}
+    static uint64_t make(uint64_t philosopher, uint64_t flags) {return philosopher << OWNER_SHIFT | flags;}
+
+    // The other philosopher sharing fork f with philosopher p
+    int neighbour(int fork, int philosopher) const {
+        return fork == philosopher ? (philosopher + count - 1) % count : (philosopher + 1) % count;
+    }
+
+    // One step of getting fork f to p: true once p owns it and it is safe to use
+    bool claim(int fork, int philosopher) {
+        std::atomic<uint64_t>& word = forks[fork].value;
+        uint64_t state = word.load(std::memory_order_acquire);
+        if (owner(state) == static_cast<uint64_t>(philosopher)) {
+            if ((state & (DIRTY | REQUESTED)) == (DIRTY | REQUESTED)) {
+                word.compare_exchange_strong(state, make(neighbour(fork, philosopher), 0), std::memory_order_acq_rel);
+                return false;
+            }
+            return true;
+        }
+        if ((state & (DIRTY | IN_USE)) == DIRTY) {
+            word.compare_exchange_strong(state, make(philosopher, 0), std::memory_order_acq_rel);
+        } else if (!(state & REQUESTED)) {
+            word.compare_exchange_strong(state, state | REQUESTED, std::memory_order_acq_rel);
+        }
+        return false;
+    }
+
+    // Marks an owned fork in use; fails if it changed hands or must be handed over first
+    bool lock(int fork, int philosopher) {
+        std::atomic<uint64_t>& word = forks[fork].value;
+        uint64_t state = word.load(std::memory_order_acquire);
+        if (owner(state) != static_cast<uint64_t>(philosopher) || (state & (DIRTY | REQUESTED)) == (DIRTY | REQUESTED)) {
+            return false;
+        }
+        return word.compare_exchange_strong(state, state | IN_USE, std::memory_order_acq_rel);
+    }
+
+    // After eating: dirty and kept, or clean and handed to the neighbour if it asked meanwhile
+    void put_down(int fork, int philosopher) {
+        std::atomic<uint64_t>& word = forks[fork].value;
+        uint64_t state = word.load(std::memory_order_acquire);
+        uint64_t next;
+        do {
+            next = (state & REQUESTED) ? make(neighbour(fork, philosopher), 0) : make(philosopher, DIRTY);
+        } while (!word.compare_exchange_weak(state, next, std::memory_order_acq_rel));
+    }
+
+public:
+    const char* name() const override {return "Chandy-Misra";}
+
+    void start(int philosophers) override {
+        count = philosophers;
+        forks.reset(new padded_atomic[philosophers]);
+        for (int fork = 0; fork < philosophers; fork++) {
+            uint64_t lower = std::min((fork + philosophers - 1) % philosophers, fork);
+            forks[fork].value.store(make(lower, DIRTY), std::memory_order_relaxed);
+        }
+    }
+
+    void acquire(int philosopher) override {
+        const int left = philosopher, right = (philosopher + 1) % count;
+        unsigned spins = 0;
+        uint64_t failures = 0;
+        for (;; spin_wait(spins)) {
+            bool have_left = claim(left, philosopher);
+            bool have_right = claim(right, philosopher);
+            failures += !have_left + !have_right;
+            if (!have_left || !have_right) continue;
+            if (!lock(left, philosopher)) {
+                failures++;
+                continue;
+            }
+            if (lock(right, philosopher)) break;
+            failures++;
+            forks[left].value.fetch_and(~IN_USE, std::memory_order_acq_rel);
+        }
+        report_contention(philosopher, failures, spins);
+    }
+
+    void release(int philosopher) override {
+        put_down((philosopher + 1) % count, philosopher);
+        put_down(philosopher, philosopher);
+    }
+};
+
+// Intrusive multi-producer single-consumer queue (Vyukov): push is one exchange, nodes are
+// owned by the producers and reused, so nothing is allocated on the hot path
+struct mpsc_node {
+    std::atomic<mpsc_node*> next{nullptr};
+    int philosopher = 0;
+    bool release = false;
+};
+
+class MpscQueue {
+private:
+    alignas(64) std::atomic<mpsc_node*> head;
+    alignas(64) mpsc_node* tail;
+    mpsc_node stub;
+
+public:
+    MpscQueue() : head(&stub), tail(&stub) {}
+
+    void push(mpsc_node* node) {
+        node->next.store(nullptr, std::memory_order_relaxed);
+        mpsc_node* previous = head.exchange(node, std::memory_order_acq_rel);
+        previous->next.store(node, std::memory_order_release);
+    }
+
+    // Consumer only; nullptr when empty or a producer is between its two steps
+    mpsc_node* pop() {
+        mpsc_node* node = tail;
+        mpsc_node* next = node->next.load(std::memory_order_acquire);
+        if (node == &stub) {
+            if (!next) return nullptr;
+            tail = next;
+            node = next;
+            next = next->next.load(std::memory_order_acquire);
+        }
+        if (next) {
+            tail = next;
+            return node;
+        }
+        if (node != head.load(std::memory_order_acquire)) return nullptr;
+        push(&stub);
+        next = node->next.load(std::memory_order_acquire);
+        if (next) {
+            tail = next;
+            return node;
+        }
+        return nullptr;
+    }
+};
+
+// A waiter thread owns every chopstick. Philosophers post requests and releases to it through
+// an MPSC queue and spin on their own grant flag. A request is granted once both chopsticks
+// are free and neither neighbour has an older request waiting, which keeps the waiter
+// starvation-free while non-adjacent philosophers still eat at the same time.
+class WaiterStrategy : public ArbitrationStrategy {
+private:
+    int count = 0;
+    std::unique_ptr<MpscQueue> queue;
+    std::unique_ptr<padded_atomic[]> granted;
+    std::vector<mpsc_node> request_nodes, release_nodes;
+    std::atomic<bool> running{false};
+    std::thread waiter;
+
+    // Waiter-only state
+    std::vector<char> busy, pending;
+    std::vector<uint64_t> ticket;
+    uint64_t next_ticket = 0;
+
+    bool older_neighbour_waiting(int philosopher) const {
+        int left = (philosopher + count - 1) % count, right = (philosopher + 1) % count;
+        return (pending[left] && ticket[left] < ticket[philosopher]) ||
+               (pending[right] && ticket[right] < ticket[philosopher]);
+    }
+
+    void try_grant(int philosopher) {
+        int right = (philosopher + 1) % count;
+        if (!pending[philosopher] || busy[philosopher] || busy[right] || older_neighbour_waiting(philosopher)) return;
+        busy[philosopher] = busy[right] = 1;
+        pending[philosopher] = 0;
+        granted[philosopher].value.store(1, std::memory_order_release);
+    }
+
+    void serve() {
+        unsigned spins = 0;
+        while (running.load(std::memory_order_acquire)) {
+            mpsc_node* node = queue->pop();
+            if (!node) {
+                spin_wait(spins);
+                continue;
+            }
+            spins = 0;
+            const int philosopher = node->philosopher;
+            if (node->release) {
+                busy[philosopher] = busy[(philosopher + 1) % count] = 0;
+                try_grant((philosopher + count - 1) % count);
+                try_grant((philosopher + 1) % count);
+            } else {
+                pending[philosopher] = 1;
+                ticket[philosopher] = next_ticket++;
+                try_grant(philosopher);
+            }
+        }
+    }
+
+public:
+    const char* name() const override {return "waiter (MPSC queue)";}
+
+    void start(int philosophers) override {
+        count = philosophers;
+        granted.reset(new padded_atomic[philosophers]);
+        request_nodes = std::vector<mpsc_node>(philosophers);
+        release_nodes = std::vector<mpsc_node>(philosophers);
+        for (int i = 0; i < philosophers; i++) {
+            request_nodes[i].philosopher = release_nodes[i].philosopher = i;
+            release_nodes[i].release = true;
+        }
+        queue.reset(new MpscQueue());
+        busy.assign(philosophers, 0);
+        pending.assign(philosophers, 0);
+        ticket.assign(philosophers, 0);
+        running = true;
+        waiter = std::thread(&WaiterStrategy::serve, this);
+    }
+
+    void acquire(int philosopher) override {
+        granted[philosopher].value.store(0, std::memory_order_relaxed);
+        queue->push(&request_nodes[philosopher]);
+        unsigned spins = 0;
+        while (!granted[philosopher].value.load(std::memory_order_acquire)) spin_wait(spins);
+        report_contention(philosopher, 0, spins);
+    }
+
+    void release(int philosopher) override {
+        queue->push(&release_nodes[philosopher]);
+    }
+
+    void stop() override {
+        running = false;
+        if (waiter.joinable()) waiter.join();
+    }
+};
+
+struct table_result {
+    double seconds = 0;
+    uint64_t meals = 0;
+    uint64_t exclusion_violations = 0;    // neighbours seen eating at once, only counted with verify
+    std::vector<uint64_t> meals_per_philosopher;
+
+    double meals_per_second() const {return seconds > 0 ? meals / seconds : 0;}
+};
+
+// Runs any number of philosophers, one thread each, against an ArbitrationStrategy for a fixed
+// wall-clock time. Thinking and eating are busy loops of think_work / eat_work iterations, so
+// throughput measures the arbitration rather than sleep granularity. With verify set, each
+// chopstick also records who is eating with it, to catch two neighbours eating at once.
+class PhilosopherEngine {
+private:
+    int count;
+    unsigned think_work, eat_work;
+    bool verify;
+    ContentionMetrics* metrics = nullptr;
+
+public:
+    PhilosopherEngine(int philosophers, unsigned think_work = 200, unsigned eat_work = 200, bool verify = false)
+        : count(std::max(philosophers, 2)), think_work(think_work), eat_work(eat_work), verify(verify) {}
+
+    // Latencies and contention of the next runs go to contention, which needs a slot for every
+    // philosopher; timing costs a few clock reads per meal, so leave it detached for raw throughput
+    void attach_metrics(ContentionMetrics* contention) {
+        if (contention && contention->philosopher_count() < count) throw std::invalid_argument("metrics table too small");
+        metrics = contention;
+    }
+
+    table_result run(ArbitrationStrategy& strategy, std::chrono::milliseconds duration) {
+        strategy.start(count);
+        strategy.attach_metrics(metrics);
+        std::atomic<bool> running{true};
+        std::atomic<uint64_t> violations{0};
+        std::unique_ptr<padded_counter[]> meals(new padded_counter[count]);
+        std::unique_ptr<padded_atomic[]> holders(new padded_atomic[count]);
+
+        // Nobody starts before every thread exists, so the clock covers the whole table
+        std::mutex gate_mutex;
+        std::condition_variable gate;
+        bool open = false;
+
+        auto philosopher = [&](int id) {
+            const int right = (id + 1) % count;
+            {
+                std::unique_lock<std::mutex> lock(gate_mutex);
+                gate.wait(lock, [&open] {return open;});
+            }
+            std::chrono::steady_clock::time_point hungry_at, eating_at;
+            while (running.load(std::memory_order_relaxed)) {
+                busy_work(think_work);
+                if (metrics) hungry_at = std::chrono::steady_clock::now();
+                strategy.acquire(id);
+                if (metrics) {
+                    eating_at = std::chrono::steady_clock::now();
+                    metrics->record_acquire(id, eating_at - hungry_at);
+                }
+                if (verify) {
+                    violations += holders[id].value.exchange(id + 1) != 0;
+                    violations += holders[right].value.exchange(id + 1) != 0;
+                }
+                if (metrics) metrics->record_meal(id, std::chrono::steady_clock::now() - hungry_at);
+                busy_work(eat_work);
+                meals[id].value++;
+                if (verify) {
+                    holders[right].value.store(0);
+                    holders[id].value.store(0);
+                }
+                strategy.release(id);
+                if (metrics) metrics->record_hold(id, std::chrono::steady_clock::now() - eating_at);
+            }
+        };
+
+        std::vector<std::thread> threads;
+        threads.reserve(count);
+        for (int id = 0; id < count; id++) {
+            threads.emplace_back(philosopher, id);
+        }
+        {
+            std::lock_guard<std::mutex> lock(gate_mutex);
+            open = true;
+        }
+        gate.notify_all();
+        auto start = std::chrono::steady_clock::now();
+        std::this_thread::sleep_for(duration);
+        running = false;
+        for (auto& thread : threads) {
+            thread.join();
+        }
+        table_result result;
+        result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        strategy.stop();
+        strategy.attach_metrics(nullptr);
+
+        result.exclusion_violations = violations;
+        for (int id = 0; id < count; id++) {
+            result.meals_per_philosopher.push_back(meals[id].value);
+            result.meals += meals[id].value;
+        }
+        return result;
+    }
+};
+
+#if defined(__cpp_lib_coroutine)
+class CoroutineRuntime;
+
+// A philosopher as a coroutine. It starts suspended so the runtime picks the worker it first
+// runs on, and its frame frees itself on return after telling the runtime it is done.
+struct philosopher_task {
+    struct promise_type {
+        CoroutineRuntime* runtime = nullptr;
+
+        // Frames are the whole per-philosopher stack, so remember how big they are
+        static void* operator new(size_t size) {
+            frame_size.store(size, std::memory_order_relaxed);
+            return ::operator new(size);
+        }
+        static void operator delete(void* frame) {::operator delete(frame);}
+
+        philosopher_task get_return_object() {return {std::coroutine_handle<promise_type>::from_promise(*this)};}
+        std::suspend_always initial_suspend() noexcept {return {};}
+        std::suspend_never final_suspend() noexcept {return {};}
+        void return_void();
+        void unhandled_exception() {std::terminate();}
+    };
+
+    static inline std::atomic<size_t> frame_size{0};
+    std::coroutine_handle<promise_type> handle;
+};
+
+// M:N scheduler: any number of coroutines on a fixed pool of workers. Each worker has its own
+// deque of ready coroutines and steals from the others when it runs dry. A worker takes from
+// the front of its own deque, so a coroutine that yields goes behind everyone already waiting,
+// and steals from the back. Worker 0 is the thread that calls run().
+class CoroutineRuntime {
+private:
+    struct alignas(64) WorkerQueue {
+        std::mutex lock;
+        std::deque<std::coroutine_handle<>> ready;
+    };
+
+    unsigned workers;
+    std::unique_ptr<WorkerQueue[]> queues;
+    std::atomic<size_t> live{0};
+    std::atomic<size_t> next_queue{0};
+
+    static inline thread_local CoroutineRuntime* current_runtime = nullptr;
+    static inline thread_local unsigned current_worker = 0;
+
+    std::coroutine_handle<> take(unsigned self) {
+        {
+            std::lock_guard<std::mutex> lock(queues[self].lock);
+            if (!queues[self].ready.empty()) {
+                std::coroutine_handle<> next = queues[self].ready.front();
+                queues[self].ready.pop_front();
+                return next;
+            }
+        }
+        for (unsigned offset = 1; offset < workers; offset++) {
+            WorkerQueue& victim = queues[(self + offset) % workers];
+            std::lock_guard<std::mutex> lock(victim.lock);
+            if (!victim.ready.empty()) {
+                std::coroutine_handle<> next = victim.ready.back();
+                victim.ready.pop_back();
+                return next;
+            }
+        }
+        return nullptr;
+    }
+
+    void work(unsigned self) {
+        current_runtime = this;
+        current_worker = self;
+        unsigned spins = 0;
+        while (live.load(std::memory_order_acquire) != 0) {
+            std::coroutine_handle<> next = take(self);
+            if (!next) {
+                spin_wait(spins);
+                continue;
+            }
+            spins = 0;
+            next.resume();
+        }
+        current_runtime = nullptr;
+    }
+
+public:
+    // Suspends the awaiting coroutine and puts it at the back of its worker's queue
+    struct yield_awaiter {
+        CoroutineRuntime& runtime;
+        bool await_ready() const noexcept {return false;}
+        void await_suspend(std::coroutine_handle<> handle) {runtime.schedule(handle);}
+        void await_resume() const noexcept {}
+    };
+
+    explicit CoroutineRuntime(unsigned workers = std::thread::hardware_concurrency())
+        : workers(std::max(workers, 1u)), queues(new WorkerQueue[std::max(workers, 1u)]) {}
+
+    unsigned worker_count() const {return workers;}
+
+    // Makes a coroutine ready; from a worker it stays local, from outside it is dealt round robin
+    void schedule(std::coroutine_handle<> handle) {
+        unsigned target = current_runtime == this ? current_worker
+                                                  : next_queue.fetch_add(1, std::memory_order_relaxed) % workers;
+        std::lock_guard<std::mutex> lock(queues[target].lock);
+        queues[target].ready.push_back(handle);
+    }
+
+    void spawn(philosopher_task task) {
+        task.handle.promise().runtime = this;
+        live.fetch_add(1, std::memory_order_relaxed);
+        schedule(task.handle);
+    }
+
+    void finished() {live.fetch_sub(1, std::memory_order_acq_rel);}
+
+    yield_awaiter yield() {return {*this};}
+
+    // Runs until every spawned coroutine has returned
+    void run() {
+        std::vector<std::thread> pool;
+        for (unsigned worker = 1; worker < workers; worker++) {
+            pool.emplace_back(&CoroutineRuntime::work, this, worker);
+        }
+        work(0);
+        for (auto& thread : pool) {
+            thread.join();
+        }
+    }
+};
+
+inline void philosopher_task::promise_type::return_void() {
+    runtime->finished();
+}
+
+// A chopstick coroutines wait for without blocking a worker: a taken chopstick queues the
+// awaiting coroutine in its own FIFO, and release hands it straight to the oldest waiter.
+// Waiters are the awaiters themselves, which live in the waiting coroutine's frame.
+class AsyncChopstick {
+private:
+    struct acquire_awaiter {
+        AsyncChopstick& chopstick;
+        std::coroutine_handle<> handle;
+        acquire_awaiter* next = nullptr;
+
+        bool await_ready() const noexcept {return false;}
+        // Once queued the coroutine may already be running elsewhere, so nothing touches this after
+        bool await_suspend(std::coroutine_handle<> awaiting) {
+            handle = awaiting;
+            return chopstick.enqueue(this);
+        }
+        void await_resume() const noexcept {}
+    };
+
+    std::atomic<bool> guard{false};
+    bool taken = false;
+    acquire_awaiter* head = nullptr;
+    acquire_awaiter* tail = nullptr;
+
+    void lock_guard() {
+        unsigned spins = 0;
+        while (guard.exchange(true, std::memory_order_acquire)) spin_wait(spins);
+    }
+
+    void unlock_guard() {guard.store(false, std::memory_order_release);}
+
+    // Takes a free chopstick and returns false, or queues the waiter and returns true
+    bool enqueue(acquire_awaiter* waiter) {
+        lock_guard();
+        if (!taken) {
+            taken = true;
+            unlock_guard();
+            return false;
+        }
+        if (tail) tail->next = waiter;
+        else head = waiter;
+        tail = waiter;
+        unlock_guard();
+        return true;
+    }
+
+public:
+    acquire_awaiter acquire() {return {*this, nullptr, nullptr};}
+
+    void release(CoroutineRuntime& runtime) {
+        lock_guard();
+        acquire_awaiter* waiter = head;
+        if (waiter) {
+            head = waiter->next;
+            if (!head) tail = nullptr;
+        } else {
+            taken = false;
+        }
+        unlock_guard();
+        if (waiter) runtime.schedule(waiter->handle);
+    }
+};
+
+// PhilosopherEngine's table with coroutines instead of threads: every philosopher takes its
+// lower-numbered chopstick first, so the waits can never form a cycle, and yields its worker
+// after each meal. Per philosopher that costs one coroutine frame, one chopstick and a meal
+// counter, so a table of 10^5 fits in a few tens of megabytes.
+class CoroutineTable {
+private:
+    int count;
+    unsigned think_work, eat_work;
+    bool verify;
+
+    std::atomic<bool> running{false};
+    std::unique_ptr<AsyncChopstick[]> chopsticks;
+    std::unique_ptr<uint64_t[]> meals;
+    std::unique_ptr<std::atomic<int>[]> holders;
+    std::atomic<uint64_t> violations{0};
+
+    static philosopher_task dine(CoroutineTable& table, CoroutineRuntime& runtime, int id) {
+        const int right = (id + 1) % table.count;
+        AsyncChopstick& first = table.chopsticks[std::min(id, right)];
+        AsyncChopstick& second = table.chopsticks[std::max(id, right)];
+        while (table.running.load(std::memory_order_relaxed)) {
+            busy_work(table.think_work);
+            co_await first.acquire();
+            co_await second.acquire();
+            if (table.verify) {
+                table.violations += table.holders[id].exchange(id + 1) != 0;
+                table.violations += table.holders[right].exchange(id + 1) != 0;
+            }
+            busy_work(table.eat_work);
+            table.meals[id]++;
+            if (table.verify) {
+                table.holders[right].store(0);
+                table.holders[id].store(0);
+            }
+            second.release(runtime);
+            first.release(runtime);
+            co_await runtime.yield();
+        }
+    }
+
+public:
+    CoroutineTable(int philosophers, unsigned think_work = 200, unsigned eat_work = 200, bool verify = false)
+        : count(std::max(philosophers, 2)), think_work(think_work), eat_work(eat_work), verify(verify) {}
+
+    table_result run(CoroutineRuntime& runtime, std::chrono::milliseconds duration) {
+        chopsticks.reset(new AsyncChopstick[count]);
+        meals.reset(new uint64_t[count]());
+        holders.reset(verify ? new std::atomic<int>[count]() : nullptr);
+        violations = 0;
+        running = true;
+        for (int id = 0; id < count; id++) {
+            runtime.spawn(dine(*this, runtime, id));
+        }
+
+        auto start = std::chrono::steady_clock::now();
+        std::thread timer([this, duration] {
+            std::this_thread::sleep_for(duration);
+            running = false;
+        });
+        runtime.run();
+        timer.join();
+
+        table_result result;
+        result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        result.exclusion_violations = violations;
+        result.meals_per_philosopher.assign(meals.get(), meals.get() + count);
+        result.meals = std::accumulate(result.meals_per_philosopher.begin(), result.meals_per_philosopher.end(), uint64_t{0});
+        return result;
+    }
+
+    // Frame, chopstick and meal counter (plus the verify slot) for one philosopher
+    size_t bytes_per_philosopher() const {
+        return philosopher_task::frame_size.load(std::memory_order_relaxed) + sizeof(AsyncChopstick) +
+               sizeof(uint64_t) + (verify ? sizeof(std::atomic<int>) : 0);
+    }
+};
+#endif
+
 // Test Cases
 class DiningPhilosophersTest {
 private:
@@ -144,23 +1715,48 @@ private:
 
 public:
     static void run_all_tests() {
-        test_fairness();
-        test_concurrent_eating();
-        test_no_deadlock();
-        test_wait_times();
+        run_test("Fairness", test_fairness);
+        run_test("Concurrent eating", test_concurrent_eating);
+        run_test("No deadlock", test_no_deadlock);
+        run_test("Wait times", test_wait_times);
+        run_test("Arbitration strategies", test_strategies);
+        run_test("Event tracing", test_tracing);
+        run_test("Deterministic virtual time", test_determinism);
+#if defined(__cpp_lib_coroutine)
+        run_test("Coroutine runtime", test_coroutines);
+#endif
+        run_test("Contention metrics", test_metrics);
     }
 
     // Test 1: Fairness - Each philosopher should get to eat a similar number of times
     static bool test_fairness() {
-        DiningPhilosophers dp;
-        dp.start_simulation(10); // Run for 10 seconds
+        DiningPhilosophers dp(1965);
+        VirtualScheduler virtual_time(DiningPhilosophers::philosopher_count());
+        dp.attach_scheduler(&virtual_time);
+        std::string trace_path = (std::filesystem::temp_directory_path() / "philosophers_fairness.trace").string();
+        EventTracer tracer(trace_path, DiningPhilosophers::philosopher_count(), 1 << 16, 1000);
+        dp.attach_tracer(&tracer);
+        bool completed = dp.start_simulation(std::chrono::hours(1)); // One hour of virtual dinner
+        tracer.close();
         
         auto eat_counts = dp.get_eat_counts();
         int min_count = *std::min_element(eat_counts.begin(), eat_counts.end());
         int max_count = *std::max_element(eat_counts.begin(), eat_counts.end());
+
+        // The trace holds one Hungry -> Eating wait per meal
+        bool traced = true;
+        {
+            TraceReport report(trace_path);
+            auto histograms = report.wait_histograms();
+            for (int i = 0; i < DiningPhilosophers::philosopher_count(); i++) {
+                uint64_t waits = std::accumulate(histograms[i].begin(), histograms[i].end(), uint64_t{0});
+                traced = traced && waits == static_cast<uint64_t>(eat_counts[i]);
+            }
+        }
+        std::filesystem::remove(trace_path);
         
         // No philosopher should eat more than twice as much as any other
-        bool is_fair = (max_count <= min_count * 2);
+        bool is_fair = completed && traced && (max_count <= min_count * 2);
         
         std::cout << "Min eats: " << min_count << ", Max eats: " << max_count << std::endl;
         return is_fair;
@@ -168,75 +1764,263 @@ public:
 
     // Test 2: Concurrent Eating - Non-adjacent philosophers should be able to eat simultaneously
     static bool test_concurrent_eating() {
-        DiningPhilosophers dp;
-        std::atomic<int> max_concurrent{0};
-        std::atomic<int> current_eating{0};
-        
-        // Modified philosopher method to track concurrent eating
-        auto concurrent_philosopher = [&](int id) {
-            while (current_eating > 0) {
-                int current = current_eating.load();
-                max_concurrent = std::max(max_concurrent.load(), current);
-                std::this_thread::sleep_for(std::chrono::milliseconds(100));
-            }
-        };
-
-        std::vector<std::thread> philosophers;
-        for (int i = 0; i < 5; i++) {
-            philosophers.emplace_back(concurrent_philosopher, i);
-        }
-
-        std::this_thread::sleep_for(std::chrono::seconds(5));
-        
-        for (auto& phil : philosophers) {
-            phil.join();
-        }
+        DiningPhilosophers dp(2);
+        VirtualScheduler virtual_time(DiningPhilosophers::philosopher_count());
+        dp.attach_scheduler(&virtual_time);
+        dp.start_simulation(std::chrono::minutes(10));
 
+        int max_concurrent = dp.get_max_concurrent_eating();
         std::cout << "Maximum concurrent philosophers eating: " << max_concurrent << std::endl;
         return max_concurrent >= 2; // At least 2 philosophers should eat concurrently
     }
 
-    // Test 3: No Deadlock - Program should continue running without hanging
+    // Test 3: No Deadlock - every seed finishes, and the scheduler does catch a real deadlock
     static bool test_no_deadlock() {
-        DiningPhilosophers dp;
-        std::atomic<bool> completed{false};
-        
-        std::thread test_thread([&]() {
-            dp.start_simulation(5);
-            completed = true;
-        });
+        bool completed = true;
+        for (uint64_t seed = 1; seed <= 20; seed++) {
+            DiningPhilosophers dp(seed);
+            VirtualScheduler virtual_time(DiningPhilosophers::philosopher_count());
+            dp.attach_scheduler(&virtual_time);
+            completed = completed && dp.start_simulation(std::chrono::minutes(10));
+        }
 
-        // Wait for up to 7 seconds (5 seconds simulation + 2 seconds buffer)
-        std::this_thread::sleep_for(std::chrono::seconds(7));
-        test_thread.join();
+        // Two threads taking two locks in opposite order, each pausing in between
+        VirtualScheduler opposite_order(2);
+        bool deadlock_caught = !opposite_order.run(2, [&opposite_order](int id) {
+            opposite_order.lock(id, id);
+            opposite_order.sleep_for(id, std::chrono::milliseconds(10));
+            opposite_order.lock(id, 1 - id);
+        });
 
-        std::cout << "Simulation " << (completed ? "completed normally" : "may have deadlocked") << std::endl;
-        return completed;
+        std::cout << "Simulation " << (completed ? "completed normally" : "deadlocked")
+                  << (deadlock_caught ? ", lock-order deadlock detected" : ", lock-order deadlock missed") << std::endl;
+        return completed && deadlock_caught;
     }
 
-    // Test 4: Wait Times - Check that no philosopher waits too long
+    // Test 4: Wait Times - Check that no philosopher waits too long. Over a 10 second dinner a few
+    // unlucky seeds do wait more than 5 seconds, so every seed now dines for 10 minutes
     static bool test_wait_times() {
-        DiningPhilosophers dp;
-        dp.start_simulation(10);
-        
-        auto wait_times = dp.get_wait_times();
-        auto max_wait = std::max_element(wait_times.begin(), wait_times.end());
+        std::chrono::milliseconds max_wait{0};
+        for (uint64_t seed = 1; seed <= 20; seed++) {
+            DiningPhilosophers dp(seed);
+            VirtualScheduler virtual_time(DiningPhilosophers::philosopher_count());
+            dp.attach_scheduler(&virtual_time);
+            dp.start_simulation(std::chrono::minutes(10));
+            auto wait_times = dp.get_wait_times();
+            max_wait = std::max(max_wait, *std::max_element(wait_times.begin(), wait_times.end()));
+        }
         
-        std::cout << "Maximum wait time: " << max_wait->count() << "ms" << std::endl;
+        std::cout << "Maximum wait time: " << max_wait.count() << "ms" << std::endl;
         
-        // No philosopher should wait more than 5 seconds total
-        return max_wait->count() < 5000;
+        // No philosopher should spend half of the dinner waiting
+        return max_wait < std::chrono::minutes(5);
+    }
+
+    // Test 5: Every strategy keeps neighbours from eating together and feeds every philosopher,
+    // for a small table and a large one
+    static bool test_strategies() {
+        OrderedMutexStrategy ordered;
+        BackoffStrategy backoff;
+        ChandyMisraStrategy chandy_misra;
+        WaiterStrategy waiter;
+        bool passed = true;
+        for (ArbitrationStrategy* strategy : std::initializer_list<ArbitrationStrategy*>{&ordered, &backoff, &chandy_misra, &waiter}) {
+            for (int philosophers : {2, 5, 257}) {
+                PhilosopherEngine engine(philosophers, 100, 100, true);
+                table_result result = engine.run(*strategy, std::chrono::milliseconds(300));
+                uint64_t hungriest = *std::min_element(result.meals_per_philosopher.begin(), result.meals_per_philosopher.end());
+                if (result.exclusion_violations != 0 || hungriest == 0) {
+                    std::cout << strategy->name() << " with " << philosophers << " philosophers: "
+                              << result.exclusion_violations << " violations, least meals " << hungriest << std::endl;
+                    passed = false;
+                }
+            }
+        }
+        return passed;
     }
+
+    // Test 6: Every event reaches the trace file or is counted as dropped, in order per philosopher
+    static bool test_tracing() {
+        std::string path = (std::filesystem::temp_directory_path() / "philosophers_test.trace").string();
+        const int threads = 4, per_thread = 200000;
+        {
+            EventTracer tracer(path, threads, 1024);
+            std::vector<std::thread> producers;
+            for (int id = 0; id < threads; id++) {
+                producers.emplace_back([&tracer, id] {
+                    for (int i = 0; i < per_thread; i++) tracer.record(id, static_cast<philosopher_state>(i & 3));
+                });
+            }
+            for (auto& producer : producers) producer.join();
+        }
+        TraceReport report(path);
+        bool passed = report.get_header().events + report.get_header().dropped == uint64_t{threads} * per_thread;
+        for (int id = 0; id < threads; id++) {
+            const auto& events = report.events_of(id);
+            for (size_t i = 1; i < events.size(); i++) passed = passed && events[i - 1].timestamp <= events[i].timestamp;
+        }
+        passed = passed && report.render_timeline(40).size() == threads * (5 + 40 + 2);
+        std::filesystem::remove(path);
+        return passed;
+    }
+
+    // Test 7: A seed fixes the whole dinner: lock-step threads repeat themselves exactly, and the
+    // single-threaded event loop reproduces them
+    static bool test_determinism() {
+        auto lock_step = [](uint64_t seed, std::chrono::milliseconds duration) {
+            DiningPhilosophers dp(seed);
+            VirtualScheduler virtual_time(DiningPhilosophers::philosopher_count());
+            dp.attach_scheduler(&virtual_time);
+            dp.start_simulation(duration);
+            return std::make_pair(dp.get_eat_counts(), dp.get_wait_times());
+        };
+        bool passed = true;
+        for (uint64_t seed : {7ULL, 1965ULL, 123456789ULL}) {
+            auto threads = lock_step(seed, std::chrono::minutes(30));
+            dinner_statistics single = DinnerSimulation::run(seed, std::chrono::minutes(30));
+            passed = passed && threads == lock_step(seed, std::chrono::minutes(30));
+            passed = passed && threads.first == single.eat_counts && threads.second == single.wait_times;
+        }
+        passed = passed && lock_step(1, std::chrono::minutes(30)) != lock_step(2, std::chrono::minutes(30));
+
+        // A day of dinner on one thread, checked for starvation
+        dinner_statistics day = DinnerSimulation::run(42, std::chrono::hours(24));
+        passed = passed && !day.deadlocked && *std::min_element(day.eat_counts.begin(), day.eat_counts.end()) > 10000;
+        return passed;
+    }
+
+#if defined(__cpp_lib_coroutine)
+    // Test 8: Coroutine philosophers keep neighbours apart and all get fed, from two of them up
+    // to 10^5 on a handful of workers, in under a kilobyte each
+    static bool test_coroutines() {
+        bool passed = true;
+        for (int philosophers : {2, 5, 257, 100000}) {
+            CoroutineRuntime runtime(4);
+            CoroutineTable table(philosophers, 100, 100, true);
+            // The first round through 10^5 coroutines takes a while on a slow (sanitized) build,
+            // so the big table dines longer; everyone must still eat, and about equally often
+            table_result result = table.run(runtime, std::chrono::milliseconds(philosophers < 100000 ? 300 : 3000));
+            uint64_t hungriest = *std::min_element(result.meals_per_philosopher.begin(), result.meals_per_philosopher.end());
+            double fairness = jain_fairness(result.meals_per_philosopher);
+            if (result.exclusion_violations != 0 || hungriest == 0 || fairness < 0.5 || table.bytes_per_philosopher() >= 1024) {
+                std::cout << philosophers << " coroutine philosophers: " << result.exclusion_violations
+                          << " violations, least meals " << hungriest << ", fairness " << fairness << ", "
+                          << table.bytes_per_philosopher() << " bytes each" << std::endl;
+                passed = false;
+            }
+        }
+        return passed;
+    }
+#endif
+
+    // Test 9: Histograms stay within their 1/32 error, Jain's index hits both ends, and the
+    // metrics of a dinner agree with its meal counts and eating times
+    static bool test_metrics() {
+        ContentionMetrics uniform(1);
+        for (int ns = 1; ns <= 100000; ns++) uniform.record_acquire(0, std::chrono::nanoseconds(ns));
+        latency_summary latency = uniform.summary().acquire;
+        auto close = [](uint64_t reported, uint64_t exact) {return reported >= exact && reported <= exact + exact / 32;};
+        bool passed = latency.count == 100000 && close(latency.p50, 50000) && close(latency.p99, 99000) &&
+                      close(latency.p999, 99900) && latency.max == 100000;
+        passed = passed && std::abs(jain_fairness({7, 7, 7, 7}) - 1.0) < 1e-12 && std::abs(jain_fairness({9, 0, 0}) - 1.0 / 3) < 1e-12;
+
+        // Virtual time: every hold is exactly one 500-1499 ms meal
+        DiningPhilosophers dp(11);
+        VirtualScheduler virtual_time(DiningPhilosophers::philosopher_count());
+        dp.attach_scheduler(&virtual_time);
+        dp.start_simulation(std::chrono::minutes(10));
+        contention_summary dinner = dp.get_metrics().summary();
+        auto eat_counts = dp.get_eat_counts();
+        passed = passed && dinner.meals == static_cast<uint64_t>(std::accumulate(eat_counts.begin(), eat_counts.end(), 0));
+        passed = passed && dinner.hold.count == dinner.meals && dinner.acquire.count == 2 * dinner.meals;
+        passed = passed && dinner.hold.p50 >= 500000000 && dinner.hold.max <= 1499000000 && dinner.fairness > 0.5;
+
+        // Real threads: one acquire per meal, and nobody recorded a negative latency
+        BackoffStrategy backoff;
+        ContentionMetrics contention(5);
+        PhilosopherEngine engine(5, 100, 100);
+        engine.attach_metrics(&contention);
+        table_result result = engine.run(backoff, std::chrono::milliseconds(300));
+        contention_summary table = contention.summary();
+        passed = passed && table.meals == result.meals && table.acquire.count == result.meals && table.hold.count == result.meals;
+        passed = passed && table.fairness > 0 && table.fairness <= 1 && table.think_to_eat.p50 >= table.acquire.p50;
+        return passed;
+    }
+
+    // Meals per second for every strategy as the table grows
+    static void benchmark_strategies() {
+        OrderedMutexStrategy ordered;
+        BackoffStrategy backoff;
+        ChandyMisraStrategy chandy_misra;
+        WaiterStrategy waiter;
+        for (int philosophers : {5, 100, 1000, 4000}) {
+            std::cout << "\n" << philosophers << " philosophers:\n";
+            for (ArbitrationStrategy* strategy : std::initializer_list<ArbitrationStrategy*>{&ordered, &backoff, &chandy_misra, &waiter}) {
+                table_result result = PhilosopherEngine(philosophers).run(*strategy, std::chrono::milliseconds(1000));
+                uint64_t least = *std::min_element(result.meals_per_philosopher.begin(), result.meals_per_philosopher.end());
+                std::cout << "  " << strategy->name() << ": " << static_cast<uint64_t>(result.meals_per_second())
+                          << " meals/s (least fed philosopher: " << least << " meals)\n";
+
+                // A second, instrumented run for the latency and contention profile
+                ContentionMetrics contention(philosophers);
+                PhilosopherEngine instrumented(philosophers);
+                instrumented.attach_metrics(&contention);
+                instrumented.run(*strategy, std::chrono::milliseconds(1000));
+                contention.print(std::cout);
+            }
+        }
+    }
+
+#if defined(__cpp_lib_coroutine)
+    // Thread per philosopher against coroutines on one worker per core, both with ordered chopsticks
+    static void benchmark_coroutines() {
+        OrderedMutexStrategy ordered;
+        for (int philosophers : {1000, 4000, 100000}) {
+            std::cout << "\n" << philosophers << " philosophers:\n";
+            if (philosophers <= 4000) {
+                table_result threads = PhilosopherEngine(philosophers).run(ordered, std::chrono::milliseconds(1000));
+                std::cout << "  thread per philosopher: " << static_cast<uint64_t>(threads.meals_per_second()) << " meals/s\n";
+            }
+            CoroutineRuntime runtime;
+            CoroutineTable table(philosophers);
+            table_result coroutines = table.run(runtime, std::chrono::milliseconds(1000));
+            uint64_t least = *std::min_element(coroutines.meals_per_philosopher.begin(), coroutines.meals_per_philosopher.end());
+            std::cout << "  coroutines on " << runtime.worker_count() << " workers: " << static_cast<uint64_t>(coroutines.meals_per_second())
+                      << " meals/s, " << table.bytes_per_philosopher() << " bytes per philosopher (least fed philosopher: "
+                      << least << " meals)\n";
+        }
+    }
+#endif
 };
 
-int main() {
-    std::srand(std::time(nullptr));
-    
+int main(int argc, char* argv[]) {
     std::cout << "Running Dining Philosophers Tests...\n";
     
     try {
         DiningPhilosophersTest::run_all_tests();
         std::cout << "\nAll tests passed successfully!\n";
+
+        // pass --bench to compare arbitration strategies, and threads against coroutines, in meals/second
+        if (argc > 1 && std::string(argv[1]) == "--bench") {
+            DiningPhilosophersTest::benchmark_strategies();
+#if defined(__cpp_lib_coroutine)
+            DiningPhilosophersTest::benchmark_coroutines();
+#endif
+        }
+
+        // pass --trace <file> to record a 5 second dinner, --report <file> to render a recorded one
+        if (argc > 2 && std::string(argv[1]) == "--trace") {
+            DiningPhilosophers dp;
+            EventTracer tracer(argv[2], DiningPhilosophers::philosopher_count());
+            dp.attach_tracer(&tracer);
+            dp.start_simulation(5);
+            tracer.close();
+            dp.print_state(std::cout);
+            TraceReport(argv[2]).print(std::cout);
+        }
+        if (argc > 2 && std::string(argv[1]) == "--report") {
+            TraceReport(argv[2]).print(std::cout);
+        }
     }
     catch (const std::exception& expct) {
         std::cerr << "\nTest failed with exception: " << expct.what() << std::endl; // were you *expecting* something? eheh
@@ -17,61 +17,418 @@ attracting mathematicians and computer scientists for over a century.
 #include <iostream>
 #include <vector>
 #include <cassert>
+#include <cstdint>
+#include <stdexcept>
+#include <chrono>
+#include <string>
+#include <thread>
+#include <mutex>
+#include <deque>
+#include <algorithm>
+#include <array>
+#include <unordered_set>
 
-class EightQueens {
+// Fixed set of tasks spread over per-thread deques. A worker pops its own deque from the back
+// and, once that runs dry, steals from the front of the other workers' deques, so uneven
+// subtrees even out without a shared queue every task has to go through.
+class WorkStealingPool {
 private:
-    std::vector<std::vector<int>> solutions;
+    struct alignas(64) TaskQueue {
+        std::mutex lock;
+        std::deque<size_t> tasks;
+    };
+
+    unsigned threads;
+
+public:
+    explicit WorkStealingPool(unsigned threads) : threads(std::max(threads, 1u)) {}
 
-    // Check if a queen can be placed on board[row][col]
-    static bool isSafe(const std::vector<int>& board, int row, int col) {
-        // Check this row on left side
-        for (int i = 0; i < col; i++) {
-            if (board[i] == row) return false;
+    // Calls task(worker, index) exactly once for every index in [0, count)
+    template <typename Task>
+    void run(size_t count, Task task) const {
+        unsigned workers = static_cast<unsigned>(std::min<size_t>(threads, std::max<size_t>(count, 1)));
+        std::vector<TaskQueue> queues(workers);
+        // Contiguous blocks keep neighbouring subtrees on one thread until someone steals
+        for (size_t i = 0; i < count; i++) {
+            queues[i * workers / count].tasks.push_back(i);
         }
-        
-        // Check upper diagonal on left side
-        for (int i = row, j = col; i >= 0 && j >= 0; i--, j--) {
-            if (board[j] == i) return false;
+
+        auto worker = [&](unsigned self) {
+            while (true) {
+                size_t index = 0;
+                bool found = false;
+                {
+                    std::lock_guard<std::mutex> guard(queues[self].lock);
+                    if (!queues[self].tasks.empty()) {
+                        index = queues[self].tasks.back();
+                        queues[self].tasks.pop_back();
+                        found = true;
+                    }
+                }
+                for (unsigned offset = 1; !found && offset < workers; offset++) {
+                    TaskQueue& victim = queues[(self + offset) % workers];
+                    std::lock_guard<std::mutex> guard(victim.lock);
+                    if (!victim.tasks.empty()) {
+                        index = victim.tasks.front();
+                        victim.tasks.pop_front();
+                        found = true;
+                    }
+                }
+                // Tasks never spawn tasks, so empty deques everywhere means we are done
+                if (!found) return;
+                task(self, index);
+            }
+        };
+
+        std::vector<std::thread> pool;
+        for (unsigned i = 1; i < workers; i++) {
+            pool.emplace_back(worker, i);
         }
-        
-        // Check lower diagonal on left side
-        for (int i = row, j = col; j >= 0 && i < 8; i++, j--) {
-            if (board[j] == i) return false;
+        worker(0);
+        for (auto& thread : pool) {
+            thread.join();
         }
-        
-        return true;
     }
+};
+
+// Solutions stored as fixed-width records in one contiguous buffer instead of a vector per board.
+// Every column takes 5 bits (rows 0-31), twelve columns share one uint64_t, so boards up to
+// N = 12 are a single word and N = 32 needs three. Each record also carries its orbit size,
+// the number of distinct boards it stands for under the 8 symmetries of the square.
+class PackedSolutions {
+private:
+    int n;
+    size_t words_per_record;
+    std::vector<uint64_t> words;
+    std::vector<uint8_t> orbits;
+
+public:
+    static constexpr int COLUMNS_PER_WORD = 12;
+
+    explicit PackedSolutions(int n)
+        : n(n), words_per_record(static_cast<size_t>((n + COLUMNS_PER_WORD - 1) / COLUMNS_PER_WORD)) {}
 
-    // Recursive backtracking solver
-    void solveNQueens(std::vector<int>& board, int col) {
-        // Base case: If all queens are placed, save the solution
-        if (col >= 8) {
-            solutions.push_back(board);
+    // Single-word encoding of a board with at most 12 columns, usable as a hash key; wider
+    // boards need the multi-word records of push
+    static uint64_t pack(const std::vector<int>& board) {
+        assert(board.size() <= COLUMNS_PER_WORD);
+        uint64_t word = 0;
+        for (size_t col = 0; col < board.size(); col++) {
+            word |= static_cast<uint64_t>(board[col]) << (5 * col);
+        }
+        return word;
+    }
+
+    void push(const std::vector<int>& board, uint8_t orbit_size) {
+        size_t first = words.size();
+        words.resize(first + words_per_record, 0);
+        for (int col = 0; col < n; col++) {
+            words[first + col / COLUMNS_PER_WORD] |= static_cast<uint64_t>(board[col]) << (5 * (col % COLUMNS_PER_WORD));
+        }
+        orbits.push_back(orbit_size);
+    }
+
+    size_t size() const { return orbits.size(); }
+    int boardSize() const { return n; }
+    uint8_t orbitSize(size_t index) const { return orbits[index]; }
+    const uint64_t* record(size_t index) const { return words.data() + index * words_per_record; }
+    size_t memoryBytes() const { return words.size() * sizeof(uint64_t) + orbits.size(); }
+
+    std::vector<int> board(size_t index) const {
+        std::vector<int> result(n);
+        const uint64_t* packed = record(index);
+        for (int col = 0; col < n; col++) {
+            result[col] = static_cast<int>((packed[col / COLUMNS_PER_WORD] >> (5 * (col % COLUMNS_PER_WORD))) & 31);
+        }
+        return result;
+    }
+};
+
+// Bitboard N-Queens engine for boards up to 32x32.
+// Occupied rows and both diagonal directions are kept as bitmasks while filling the board
+// one column at a time, so the free squares of a column are a single mask expression and
+// every candidate is taken with mask & -mask: each placement is O(1), no rescanning.
+class NQueens {
+private:
+    int n;
+    uint64_t all; // one bit per row
+
+    // Solutions below this node: rows, down_diagonals and up_diagonals hold the squares of the
+    // current column attacked by the queens placed so far
+    uint64_t countFrom(uint64_t rows, uint64_t down_diagonals, uint64_t up_diagonals) const {
+        if (rows == all) return 1;
+        uint64_t count = 0;
+        uint64_t free = all & ~(rows | down_diagonals | up_diagonals);
+        while (free) {
+            uint64_t bit = free & (0 - free);
+            free ^= bit;
+            count += countFrom(rows | bit, ((down_diagonals | bit) << 1) & all, (up_diagonals | bit) >> 1);
+        }
+        return count;
+    }
+
+    // Calls visit(board) for every completion of board[0 .. col - 1]
+    template <typename Visit>
+    void visitFrom(std::vector<int>& board, int col, uint64_t rows, uint64_t down_diagonals,
+                   uint64_t up_diagonals, Visit& visit) const {
+        if (col == n) {
+            visit(static_cast<const std::vector<int>&>(board));
             return;
         }
-        
-        // Consider this column and try placing this queen in all rows one by one
-        for (int i = 0; i < 8; i++) {
-            // Check if queen can be placed on board[i][col]
-            if (isSafe(board, i, col)) {
-                // Place this queen in board[i][col]
-                board[col] = i;
-                
-                // Recur to place rest of the queens
-                solveNQueens(board, col + 1);
-                
-                // If placing queen in board[i][col] doesn't lead to a solution,
-                // then remove queen from board[i][col]
-                board[col] = -1;
+        uint64_t free = all & ~(rows | down_diagonals | up_diagonals);
+        while (free) {
+            uint64_t bit = free & (0 - free);
+            free ^= bit;
+            board[col] = rowOf(bit);
+            visitFrom(board, col + 1, rows | bit, ((down_diagonals | bit) << 1) & all,
+                      (up_diagonals | bit) >> 1, visit);
+        }
+        board[col] = -1;
+    }
+
+    // The 8 images of a board under rotations and reflections of the square
+    std::array<std::vector<int>, 8> symmetries(const std::vector<int>& board) const {
+        std::array<std::vector<int>, 8> images;
+        images[0] = board;
+        for (int i = 1; i < 4; i++) {
+            // rotate the previous image by 90 degrees: queen (col, row) -> (row, n - 1 - col)
+            images[i].assign(n, 0);
+            for (int col = 0; col < n; col++) {
+                images[i][images[i - 1][col]] = n - 1 - col;
+            }
+        }
+        for (int i = 0; i < 4; i++) {
+            // mirror top to bottom
+            images[i + 4].assign(n, 0);
+            for (int col = 0; col < n; col++) {
+                images[i + 4][col] = n - 1 - images[i][col];
+            }
+        }
+        return images;
+    }
+
+    // Partial board after the first few columns, with how many mirrored boards it stands for
+    struct Prefix {
+        uint64_t rows;
+        uint64_t down_diagonals;
+        uint64_t up_diagonals;
+        uint64_t weight;
+    };
+
+    // Every consistent placement of the first `depth` columns, with the first queen restricted
+    // to the upper half of the board. Mirroring a board top to bottom maps each solution with
+    // the first queen in row r to one with it in row n - 1 - r, so the upper half counts twice
+    // and only the middle row of an odd board counts once.
+    std::vector<Prefix> expandPrefixes(int depth) const {
+        std::vector<Prefix> frontier;
+        for (int row = 0; row < (n + 1) / 2; row++) {
+            uint64_t bit = uint64_t{1} << row;
+            uint64_t weight = (n % 2 == 1 && row == n / 2) ? 1 : 2;
+            frontier.push_back({bit, (bit << 1) & all, bit >> 1, weight});
+        }
+        for (int col = 1; col < depth; col++) {
+            std::vector<Prefix> next;
+            for (const Prefix& prefix : frontier) {
+                uint64_t free = all & ~(prefix.rows | prefix.down_diagonals | prefix.up_diagonals);
+                while (free) {
+                    uint64_t bit = free & (0 - free);
+                    free ^= bit;
+                    next.push_back({prefix.rows | bit, ((prefix.down_diagonals | bit) << 1) & all,
+                                    (prefix.up_diagonals | bit) >> 1, prefix.weight});
+                }
+            }
+            frontier.swap(next);
+        }
+        return frontier;
+    }
+
+    static int rowOf(uint64_t bit) {
+        int row = 0;
+        while (bit >>= 1) row++;
+        return row;
+    }
+
+public:
+    static constexpr int MAX_N = 32;
+
+    explicit NQueens(int n) : n(n) {
+        if (n < 1 || n > MAX_N) {
+            throw std::invalid_argument("NQueens supports boards from 1 to 32");
+        }
+        all = (uint64_t{1} << n) - 1;
+    }
+
+    int size() const { return n; }
+
+    // Number of solutions without storing any of them
+    uint64_t countSolutions() const {
+        return countFrom(0, 0, 0);
+    }
+
+    // Same count on a work-stealing pool: the search tree is cut after prefix_depth columns,
+    // every prefix becomes one task, and each worker sums into its own cache line
+    uint64_t countSolutionsParallel(unsigned threads = std::thread::hardware_concurrency(),
+                                    int prefix_depth = 3) const {
+        if (n == 1) return 1;
+        std::vector<Prefix> prefixes = expandPrefixes(std::clamp(prefix_depth, 1, n - 1));
+
+        struct alignas(64) Counter { uint64_t value = 0; };
+        std::vector<Counter> counters(std::max(threads, 1u));
+        WorkStealingPool(threads).run(prefixes.size(), [&](unsigned worker, size_t index) {
+            const Prefix& prefix = prefixes[index];
+            counters[worker].value += prefix.weight * countFrom(prefix.rows, prefix.down_diagonals, prefix.up_diagonals);
+        });
+
+        uint64_t total = 0;
+        for (const Counter& counter : counters) total += counter.value;
+        return total;
+    }
+
+    // Every solution as board[col] = row, in lexicographic order
+    std::vector<std::vector<int>> findSolutions() const {
+        std::vector<std::vector<int>> solutions;
+        std::vector<int> board(n, -1);
+        auto collect = [&](const std::vector<int>& solution) { solutions.push_back(solution); };
+        visitFrom(board, 0, 0, 0, 0, collect);
+        return solutions;
+    }
+
+    // One representative per symmetry class (12 for N=8): the lexicographically smallest of
+    // its 8 images, tagged with how many distinct solutions it stands for. The smallest image
+    // always has its first queen in the upper half, so the lower half is never searched.
+    PackedSolutions findUniqueSolutions() const {
+        PackedSolutions unique(n);
+        std::vector<int> board(n, -1);
+        auto keep_canonical = [&](const std::vector<int>& solution) {
+            std::array<std::vector<int>, 8> images = symmetries(solution);
+            std::sort(images.begin(), images.end());
+            if (images[0] != solution) return;
+            uint8_t orbit = static_cast<uint8_t>(std::unique(images.begin(), images.end()) - images.begin());
+            unique.push(solution, orbit);
+        };
+        for (int row = 0; row <= (n - 1) / 2; row++) {
+            uint64_t bit = uint64_t{1} << row;
+            board[0] = row;
+            visitFrom(board, 1, bit, (bit << 1) & all, bit >> 1, keep_canonical);
+        }
+        return unique;
+    }
+
+    // Print a single board configuration
+    static void printBoard(const std::vector<int>& solution) {
+        int size = static_cast<int>(solution.size());
+        for (int row = 0; row < size; row++) {
+            for (int col = 0; col < size; col++) {
+                if (solution[col] == row) {
+                    std::cout << "Q ";
+                } else {
+                    std::cout << ". ";
+                }
             }
+            std::cout << "\n";
         }
     }
+};
+
+// Resumable N-Queens search that produces one solution per next() call.
+// The backtracking stack is an explicit array inside the object, so the caller holds at most
+// one board at a time, a copy of the generator is a checkpoint to resume from later, and the
+// whole thing is usable in constant expressions.
+class NQueensGenerator {
+private:
+    // One stack frame per column: attacked squares on entry and rows still to try
+    struct Frame {
+        uint64_t rows;
+        uint64_t down_diagonals;
+        uint64_t up_diagonals;
+        uint64_t free;
+    };
+
+    int n = 0;
+    uint64_t all = 0;
+    int col = 0; // column being filled, -1 once the search is exhausted
+    // Plain arrays rather than std::array keep compile-time evaluation cheap
+    Frame stack[NQueens::MAX_N] = {};
+    uint8_t board[NQueens::MAX_N] = {};
 
 public:
-    // Constructor to solve the problem
+    constexpr explicit NQueensGenerator(int n) : n(n) {
+        if (n < 1 || n > NQueens::MAX_N) {
+            throw std::invalid_argument("NQueensGenerator supports boards from 1 to 32");
+        }
+        all = (uint64_t{1} << n) - 1;
+        stack[0].free = all;
+    }
+
+    // Advances to the next solution; returns false once every solution has been produced
+    constexpr bool next() {
+        while (col >= 0) {
+            Frame& frame = stack[col];
+            if (frame.free == 0) {
+                col--;
+                continue;
+            }
+            uint64_t bit = frame.free & (0 - frame.free);
+            frame.free ^= bit;
+            uint8_t row = 0;
+            while ((bit >> row) != 1) row++;
+            board[col] = row;
+            if (col == n - 1) return true;
+
+            Frame& child = stack[col + 1];
+            child.rows = frame.rows | bit;
+            child.down_diagonals = ((frame.down_diagonals | bit) << 1) & all;
+            child.up_diagonals = (frame.up_diagonals | bit) >> 1;
+            child.free = all & ~(child.rows | child.down_diagonals | child.up_diagonals);
+            col++;
+        }
+        return false;
+    }
+
+    // Row of the queen in column c of the current solution
+    constexpr int row(int c) const { return board[c]; }
+
+    std::vector<int> solution() const {
+        return std::vector<int>(board, board + n);
+    }
+};
+
+// Solution tables for small boards computed entirely at compile time, in lexicographic order:
+// NQueensTable<8>::solutions is a constant std::array of the 92 boards, board[col] = row.
+// N = 10 takes about 36k search steps at compile time, MSVC needs /constexpr:steps raised for it.
+template <int N>
+struct NQueensTable {
+    static_assert(N >= 1 && N <= 10, "compile-time tables are limited to N <= 10");
+
+    static constexpr size_t count = [] {
+        size_t found = 0;
+        NQueensGenerator generator(N);
+        while (generator.next()) found++;
+        return found;
+    }();
+
+    static constexpr std::array<std::array<uint8_t, N>, count> solutions = [] {
+        std::array<std::array<uint8_t, N>, count> table{};
+        NQueensGenerator generator(N);
+        for (size_t i = 0; generator.next(); i++) {
+            for (int col = 0; col < N; col++) {
+                table[i][col] = static_cast<uint8_t>(generator.row(col));
+            }
+        }
+        return table;
+    }();
+};
+
+class EightQueens {
+private:
+    std::vector<std::vector<int>> solutions;
+
+public:
+    // Constructor copies the compile-time table, no search happens at runtime
     EightQueens() {
-        std::vector<int> board(8, -1);
-        solveNQueens(board, 0);
+        for (const auto& board : NQueensTable<8>::solutions) {
+            solutions.emplace_back(board.begin(), board.end());
+        }
     }
     
     // Get total number of solutions
@@ -93,16 +450,7 @@ public:
     // Print a single board configuration
     static void printBoard(const std::vector<int>& solution)
     {
-        for (int row = 0; row < 8; row++) {
-            for (int col = 0; col < 8; col++) {
-                if (solution[col] == row) {
-                    std::cout << "Q ";
-                } else {
-                    std::cout << ". ";
-                }
-            }
-            std::cout << "\n";
-        }
+        NQueens::printBoard(solution);
     }
     
     // Get all solutions
@@ -121,19 +469,127 @@ namespace {
         // Test: Verify number of solutions
         assert(queens.getSolutionCount() == 92);
         
+        const uint64_t known[] = {1, 0, 0, 2, 10, 4, 40, 92, 352, 724, 2680, 14200, 73712};
+
         // Test: Verify solution uniqueness
         const auto& solutions = queens.getSolutions();
-        for (size_t i = 0; i < solutions.size(); ++i) {
-            for (size_t j = i + 1; j < solutions.size(); ++j) {
-                assert(solutions[i] != solutions[j]);
-            }
+        std::unordered_set<uint64_t> seen;
+        for (const auto& solution : solutions) {
+            assert(seen.insert(PackedSolutions::pack(solution)).second);
+        }
+
+        // Test: 12 canonical solutions whose orbits cover all 92, and they round-trip through packing
+        PackedSolutions unique = NQueens(8).findUniqueSolutions();
+        assert(unique.size() == 12);
+        size_t covered = 0;
+        for (size_t i = 0; i < unique.size(); ++i) {
+            covered += unique.orbitSize(i);
+            assert(seen.count(PackedSolutions::pack(unique.board(i))) == 1);
+        }
+        assert(covered == 92);
+
+        // Test: compile-time tables and the generator agree with the recursive engine
+        static_assert(NQueensTable<8>::count == 92, "92 solutions for N=8");
+        static_assert(NQueensTable<10>::count == 724, "724 solutions for N=10");
+        static_assert(NQueensTable<8>::solutions[0][1] == 4, "first solution is 0 4 7 5 2 6 1 3");
+        assert(solutions == NQueens(8).findSolutions());
+
+        std::vector<std::vector<int>> reference = NQueens(10).findSolutions();
+        NQueensGenerator generator(10);
+        for (size_t i = 0; i < 100; ++i) {
+            assert(generator.next() && generator.solution() == reference[i]);
+        }
+        NQueensGenerator checkpoint = generator;
+        size_t remaining = 0;
+        while (generator.next()) {
+            assert(checkpoint.next() && checkpoint.solution() == generator.solution());
+            assert(generator.solution() == reference[100 + remaining++]);
+        }
+        assert(remaining == 624 && !checkpoint.next());
+
+        const size_t known_unique[] = {1, 0, 0, 1, 2, 1, 6, 12, 46, 92, 341, 1787, 9233};
+        for (int n = 1; n <= 13; n++) {
+            PackedSolutions classes = NQueens(n).findUniqueSolutions();
+            size_t total = 0;
+            for (size_t i = 0; i < classes.size(); ++i) total += classes.orbitSize(i);
+            assert(classes.size() == known_unique[n - 1] && total == known[n - 1]);
         }
         
+        // Test: every queen pair of a solution is on distinct rows and diagonals
+        for (const auto& solution : solutions) {
+            for (size_t i = 0; i < solution.size(); ++i) {
+                for (size_t j = i + 1; j < solution.size(); ++j) {
+                    int rows_apart = solution[i] - solution[j];
+                    int cols_apart = static_cast<int>(j - i);
+                    assert(rows_apart != 0 && rows_apart != cols_apart && rows_apart != -cols_apart);
+                }
+            }
+        }
+
+        // Test: known solution counts for other board sizes
+        for (int n = 1; n <= 13; n++) {
+            assert(NQueens(n).countSolutions() == known[n - 1]);
+            if (n <= 10) assert(NQueens(n).findSolutions().size() == known[n - 1]);
+        }
+
+        // Test: parallel counting with mirror symmetry agrees for every prefix depth and thread count
+        for (int n = 1; n <= 11; n++) {
+            for (unsigned threads : {1u, 3u, 8u}) {
+                for (int depth : {1, 2, 4}) {
+                    assert(NQueens(n).countSolutionsParallel(threads, depth) == known[n - 1]);
+                }
+            }
+        }
+
         std::cout << "All tests passed!" << '\n';
     }
+
+    // Times the bitboard engine on larger boards
+    void runBenchmarks() {
+        const uint64_t known[] = {14200, 73712, 365596, 2279184, 14772512};
+        for (int n = 12; n <= 16; n++) {
+            auto start = std::chrono::steady_clock::now();
+            uint64_t count = NQueens(n).countSolutions();
+            std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+            assert(count == known[n - 12]);
+            std::cout << "N=" << n << ": " << count << " solutions in " << elapsed.count() * 1000 << " ms" << '\n';
+        }
+
+    }
+
+    // Memory of the canonical packed records against one heap vector per solution
+    void runStorageBenchmark(int n) {
+        auto start = std::chrono::steady_clock::now();
+        PackedSolutions unique = NQueens(n).findUniqueSolutions();
+        std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+        size_t all_solutions = 0;
+        for (size_t i = 0; i < unique.size(); i++) all_solutions += unique.orbitSize(i);
+        size_t vectors_bytes = all_solutions * (sizeof(std::vector<int>) + n * sizeof(int));
+        std::cout << "N=" << n << ": " << unique.size() << " canonical solutions in " << elapsed.count() * 1000
+                  << " ms, " << unique.memoryBytes() << " bytes packed vs at least " << vectors_bytes
+                  << " bytes as vectors of all " << all_solutions << '\n';
+    }
+
+    // Thread sweep for the parallel counter, meant for the N = 18-20 regression boards
+    void runScalingBenchmark(int n) {
+        const uint64_t known[] = {14200, 73712, 365596, 2279184, 14772512, 95815104, 666090624,
+                                  4968057848ULL, 39029188884ULL};
+        unsigned max_threads = std::max(std::thread::hardware_concurrency(), 1u);
+        double single_thread = 0;
+        std::cout << "Parallel N=" << n << " with mirror symmetry:" << '\n';
+        for (unsigned threads = 1; threads <= max_threads; threads++) {
+            auto start = std::chrono::steady_clock::now();
+            uint64_t count = NQueens(n).countSolutionsParallel(threads, 4);
+            std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+            if (threads == 1) single_thread = elapsed.count();
+            assert(n < 12 || n > 20 || count == known[n - 12]);
+            std::cout << "  " << threads << " thread(s): " << elapsed.count() * 1000 << " ms (speedup "
+                      << single_thread / elapsed.count() << "x)" << '\n';
+        }
+    }
 }
 
-int main() {
+int main(int argc, char* argv[]) {
     EightQueens queens;
     
     // Print first few solutions
@@ -145,6 +601,13 @@ int main() {
     
     // Run tests
     runTests();
+
+    // pass --bench [N] to time larger boards and the parallel counter on an N board (default 16)
+    if (argc > 1 && std::string(argv[1]) == "--bench") {
+        runBenchmarks();
+        runStorageBenchmark(12);
+        runScalingBenchmark(argc > 2 ? std::stoi(argv[2]) : 16);
+    }
     
     return 0;
 }
\ No newline at end of file
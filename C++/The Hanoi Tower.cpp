@@ -18,31 +18,736 @@ which would take approximately 585 billion years to complete.
 
 Dev Notes:
 ---------
-guess what, i didnt add any test here either!
+run_tests() checks the move generators, the Frame-Stewart solver and the move stream files.
 */
 
 #include <iostream>
+#include <array>
+#include <cstdint>
+#include <cstddef>
+#include <cassert>
+#include <iterator>
+#include <stdexcept>
+#include <vector>
+#include <string>
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <chrono>
+#include <sstream>
+#include <filesystem>
+#include <thread>
+#include <limits>
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
 using namespace std;
 
-class solution {
+// A single move: disk 1 is the smallest, pegs are 0 = source, 1 = auxiliary, 2 = destination
+struct hanoi_move {
+    int disk;
+    int from;
+    int to;
+};
+
+// The 2^n - 1 moves of an n-disk tower (n <= 64) as a lazy range, with no recursion and no heap.
+// Move k (1-based) is a pure function of k: the disk is ctz(k) + 1, and disk d cycles through
+// the pegs in a fixed direction (0 -> 2 -> 1 when n - d is even, 0 -> 1 -> 2 otherwise),
+// having moved (k >> d) times before. That gives move_at in O(1) and state_after in O(n).
+class HanoiMoves {
     public:
-    static void hanoi_tower(int n, char source, char auxiliary, char destination) {
-        // Base case: if only one disk, move directly
-        if (n == 1) {
-            std::cout << "Move disk 1 from {} to {}" << '\n';
+    static constexpr int MAX_DISKS = 64;
+
+    class iterator {
+        public:
+        using iterator_category = std::input_iterator_tag;
+        using value_type = hanoi_move;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const hanoi_move*;
+        using reference = hanoi_move;
+
+        iterator(int n, uint64_t k) : n(n), k(k) {}
+
+        hanoi_move operator*() const { return HanoiMoves::move_at(n, k); }
+        iterator& operator++() { k++; return *this; }
+        iterator operator++(int) { iterator old = *this; k++; return old; }
+        bool operator==(const iterator& other) const { return k == other.k; }
+        bool operator!=(const iterator& other) const { return k != other.k; }
+
+        // 1-based index of the move this iterator points at
+        uint64_t index() const { return k; }
+
+        private:
+        int n;
+        uint64_t k;
+    };
+
+    explicit HanoiMoves(int n) : n(n) {
+        if (n < 0 || n > MAX_DISKS) {
+            throw std::invalid_argument("HanoiMoves supports 0 to 64 disks");
+        }
+    }
+
+    // 2^n - 1, which still fits for the 64 disks of the legend
+    uint64_t size() const { return n == 0 ? 0 : ~uint64_t{0} >> (MAX_DISKS - n); }
+
+    iterator begin() const { return iterator(n, 1); }
+    // Resumes after the first k moves, e.g. from a checkpoint
+    iterator begin_at(uint64_t k) const { return iterator(n, k + 1); }
+    // One past move 2^n - 1; wraps to 0 for 64 disks, which is exactly where ++ lands
+    iterator end() const { return iterator(n, size() + 1); }
+
+    // Move number k, 1 <= k <= 2^n - 1
+    static hanoi_move move_at(int n, uint64_t k) {
+        int disk = count_trailing_zeros(k) + 1;
+        uint64_t earlier_moves = (k >> (disk - 1)) >> 1;
+        int step = direction(n, disk);
+        int from = static_cast<int>(earlier_moves % 3 * step % 3);
+        int to = static_cast<int>((earlier_moves % 3 + 1) * step % 3);
+        return {disk, from, to};
+    }
+
+    // Peg of one disk after the first k moves
+    static int peg_after(int n, int disk, uint64_t k) {
+        uint64_t half = k >> (disk - 1);
+        uint64_t moves = (half >> 1) + (half & 1);
+        return static_cast<int>(moves % 3 * direction(n, disk) % 3);
+    }
+
+    // Peg of every disk after the first k moves; entry d - 1 is disk d, unused entries are 0
+    static std::array<uint8_t, MAX_DISKS> state_after(int n, uint64_t k) {
+        std::array<uint8_t, MAX_DISKS> pegs{};
+        for (int disk = 1; disk <= n; disk++) {
+            pegs[disk - 1] = static_cast<uint8_t>(peg_after(n, disk, k));
+        }
+        return pegs;
+    }
+
+    private:
+    int n;
+
+    // Pegs advanced per move of this disk, modulo 3
+    static int direction(int n, int disk) {
+        return (n - disk) % 2 == 0 ? 2 : 1;
+    }
+
+    static int count_trailing_zeros(uint64_t k) {
+#if defined(_MSC_VER)
+        unsigned long index;
+        _BitScanForward64(&index, k);
+        return static_cast<int>(index);
+#else
+        return __builtin_ctzll(k);
+#endif
+    }
+};
+
+// Splits [0, total) into one contiguous slice per thread and calls fill(offset, count) for each.
+// Moves are pure functions of their index, so slices never need to talk to each other.
+template <typename Fill>
+void fill_in_parallel(uint64_t total, unsigned threads, Fill fill) {
+    threads = static_cast<unsigned>(std::max<uint64_t>(1, std::min<uint64_t>(std::max(threads, 1u), total)));
+    std::vector<std::thread> workers;
+    for (unsigned i = 1; i < threads; i++) {
+        uint64_t begin = total / threads * i, end = i + 1 == threads ? total : total / threads * (i + 1);
+        workers.emplace_back(fill, begin, end - begin);
+    }
+    fill(uint64_t{0}, total / threads);
+    for (auto& worker : workers) {
+        worker.join();
+    }
+}
+
+// Binary move stream file: this header, then one byte per move (bits 0-1 from peg, bits 2-3
+// to peg, upper bits zero), then one checkpoint per 2^checkpoint_shift moves holding the packed
+// peg of every disk (2 bits per disk, disk 1 lowest) before the first move of that block.
+// The disk of move k is not stored, it is ctz(k) + 1 from the byte's position.
+struct hanoi_stream_header {
+    char magic[8];             // "HANOI01"
+    uint32_t disks;
+    uint32_t checkpoint_shift;
+    uint64_t moves;            // 2^disks - 1
+    uint64_t checkpoints;
+};
+
+// Packed peg state: 2 bits per disk in two words
+struct hanoi_checkpoint {
+    uint64_t pegs[2];
+};
+
+// Turns moves into the stream format in large buffers and flushes each buffer with a single
+// unbuffered write, instead of one formatted ostream call per move
+class HanoiStreamWriter {
+    public:
+    static constexpr size_t BUFFER_BYTES = 1 << 22;
+    static constexpr uint32_t CHECKPOINT_SHIFT = 20;
+    static constexpr int TEMPLATE_DISKS = 16;
+
+    static uint8_t encode(const hanoi_move& move) {
+        return static_cast<uint8_t>(move.from | (move.to << 2));
+    }
+
+    // Encodes moves first_k .. first_k + count - 1 into out.
+    // Every aligned block of 2^16 moves is a 16-disk sub-tower moving between two pegs followed
+    // by one larger disk, so the sub-tower part is a memcpy of a pre-relabelled template and
+    // only the odd move out goes through move_at.
+    static void encode_moves(int n, uint64_t first_k, size_t count, uint8_t* out) {
+        const uint64_t block = uint64_t{1} << TEMPLATE_DISKS;
+        uint64_t k = first_k;
+        uint8_t* end = out + count;
+        while (out < end) {
+            if (n > TEMPLATE_DISKS && (k - 1) % block == 0 && static_cast<uint64_t>(end - out) >= block - 1) {
+                int from = HanoiMoves::peg_after(n, 1, k - 1);
+                int to = HanoiMoves::peg_after(n, 1, k - 1 + block - 1);
+                std::memcpy(out, sub_tower(from, to).data(), block - 1);
+                out += block - 1;
+                k += block - 1;
+            } else {
+                *out++ = encode(HanoiMoves::move_at(n, k++));
+            }
+        }
+    }
+
+    // Encoded moves of a TEMPLATE_DISKS tower going from peg `from` to peg `to`
+    static const std::vector<uint8_t>& sub_tower(int from, int to) {
+        static const std::array<std::vector<uint8_t>, 9> templates = [] {
+            std::array<std::vector<uint8_t>, 9> all;
+            for (int source = 0; source < 3; source++) {
+                for (int destination = 0; destination < 3; destination++) {
+                    if (source == destination) continue;
+                    const int labels[3] = {source, 3 - source - destination, destination};
+                    for (hanoi_move move : HanoiMoves(TEMPLATE_DISKS)) {
+                        all[source * 3 + destination].push_back(
+                            encode({move.disk, labels[move.from], labels[move.to]}));
+                    }
+                }
+            }
+            return all;
+        }();
+        return templates[from * 3 + to];
+    }
+
+    static hanoi_checkpoint checkpoint(int n, uint64_t k) {
+        hanoi_checkpoint packed{{0, 0}};
+        auto pegs = HanoiMoves::state_after(n, k);
+        for (int disk = 0; disk < n; disk++) {
+            packed.pegs[disk / 32] |= static_cast<uint64_t>(pegs[disk]) << (2 * (disk % 32));
+        }
+        return packed;
+    }
+
+    static hanoi_stream_header header_for(int n) {
+        hanoi_stream_header header{};
+        std::memcpy(header.magic, "HANOI01", 8);
+        header.disks = static_cast<uint32_t>(n);
+        header.checkpoint_shift = CHECKPOINT_SHIFT;
+        header.moves = HanoiMoves(n).size();
+        header.checkpoints = (header.moves >> CHECKPOINT_SHIFT) + 1;
+        return header;
+    }
+
+    // Encodes moves first_k .. first_k + count - 1 with every thread filling its own slice of out.
+    // Each slice seeds itself from its starting index, there is no hand-off between them.
+    static void encode_moves_parallel(int n, uint64_t first_k, size_t count, uint8_t* out, unsigned threads) {
+        fill_in_parallel(count, threads, [=](uint64_t offset, uint64_t slice) {
+            encode_moves(n, first_k + offset, static_cast<size_t>(slice), out + offset);
+        });
+    }
+
+    // Writes the full stream of an n-disk tower to path, one BUFFER_BYTES slice per thread
+    // per write call, so the file is still produced strictly in order
+    static void write(const std::string& path, int n, unsigned threads = 1) {
+        hanoi_stream_header header = header_for(n);
+        std::FILE* file = std::fopen(path.c_str(), "wb");
+        if (!file) throw std::runtime_error("cannot open " + path);
+        std::setvbuf(file, nullptr, _IONBF, 0); // every fwrite below is one write call
+
+        threads = std::max(threads, 1u);
+        std::vector<uint8_t> buffer(BUFFER_BYTES * threads);
+        bool ok = std::fwrite(&header, sizeof(header), 1, file) == 1;
+        for (uint64_t k = 1; ok && k <= header.moves; k += buffer.size()) {
+            size_t count = static_cast<size_t>(std::min<uint64_t>(buffer.size(), header.moves - k + 1));
+            encode_moves_parallel(n, k, count, buffer.data(), threads);
+            ok = std::fwrite(buffer.data(), 1, count, file) == count;
+        }
+
+        std::vector<hanoi_checkpoint> checkpoints;
+        for (uint64_t i = 0; i < header.checkpoints; i++) {
+            checkpoints.push_back(checkpoint(n, i << CHECKPOINT_SHIFT));
+        }
+        ok = ok && std::fwrite(checkpoints.data(), sizeof(hanoi_checkpoint), checkpoints.size(), file) == checkpoints.size();
+        if (std::fclose(file) != 0 || !ok) {
+            throw std::runtime_error("cannot write " + path);
+        }
+    }
+};
+
+// Read-only memory mapping of a move stream file, decoded on demand
+class HanoiStreamReader {
+    public:
+    explicit HanoiStreamReader(const std::string& path) {
+#if defined(__unix__) || defined(__APPLE__)
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) throw std::runtime_error("cannot open " + path);
+        struct stat info;
+        if (fstat(fd, &info) == 0) {
+            size = static_cast<size_t>(info.st_size);
+            void* mapped = size ? mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0) : MAP_FAILED;
+            if (mapped != MAP_FAILED) mapping = mapped;
+        }
+        ::close(fd);
+        if (!mapping) throw std::runtime_error("cannot map " + path);
+        data = static_cast<const uint8_t*>(mapping);
+#else
+        std::ifstream in(path, std::ios::binary | std::ios::ate);
+        if (!in) throw std::runtime_error("cannot open " + path);
+        size = static_cast<size_t>(in.tellg());
+        buffer.resize(size);
+        in.seekg(0);
+        in.read(reinterpret_cast<char*>(buffer.data()), static_cast<std::streamsize>(size));
+        data = buffer.data();
+#endif
+        if (size < sizeof(hanoi_stream_header)) reject("truncated " + path);
+        std::memcpy(&header, data, sizeof(header));
+        // disks bounds every shift and the two-word checkpoints, so it is checked before use
+        if (std::memcmp(header.magic, "HANOI01", 8) != 0 || header.disks == 0 || header.disks > 64 ||
+            header.checkpoint_shift >= 64 || header.moves != HanoiMoves(static_cast<int>(header.disks)).size() ||
+            header.checkpoints != (header.moves >> header.checkpoint_shift) + 1 ||
+            size != sizeof(header) + header.moves + header.checkpoints * sizeof(hanoi_checkpoint)) {
+            reject("not a move stream: " + path);
+        }
+    }
+
+    HanoiStreamReader(const HanoiStreamReader&) = delete;
+    HanoiStreamReader& operator=(const HanoiStreamReader&) = delete;
+
+    ~HanoiStreamReader() {
+#if defined(__unix__) || defined(__APPLE__)
+        if (mapping) munmap(mapping, size);
+#endif
+    }
+
+    const hanoi_stream_header& info() const { return header; }
+
+    // Raw bytes of all moves, byte k - 1 is move k
+    const uint8_t* body() const { return data + sizeof(header); }
+
+    hanoi_move move(uint64_t k) const {
+        if (k == 0 || k > header.moves) throw std::out_of_range("move number outside the stream");
+        uint8_t byte = body()[k - 1];
+        int disk = 1;
+        for (uint64_t rest = k; (rest & 1) == 0; rest >>= 1) disk++;
+        return {disk, byte & 3, (byte >> 2) & 3};
+    }
+
+    hanoi_checkpoint checkpoint(uint64_t index) const {
+        hanoi_checkpoint packed;
+        std::memcpy(&packed, body() + header.moves + index * sizeof(hanoi_checkpoint), sizeof(packed));
+        return packed;
+    }
+
+    // Replays moves first_k .. first_k + count - 1 from the checkpoint at or before first_k,
+    // checking that each one takes the top disk of its peg onto an empty peg or a larger disk.
+    // Pegs are disk bitsets, so the top disk is the lowest set bit. A range that leaves
+    // 1 .. moves is invalid, and nothing outside the stream is read.
+    bool validate(uint64_t first_k, uint64_t count) const {
+        if (first_k == 0 || count > header.moves || first_k - 1 > header.moves - count) return false;
+        uint64_t block = (first_k - 1) >> header.checkpoint_shift;
+        hanoi_checkpoint start = checkpoint(block);
+        uint64_t pegs[3] = {0, 0, 0};
+        for (uint32_t disk = 0; disk < header.disks; disk++) {
+            pegs[(start.pegs[disk / 32] >> (2 * (disk % 32))) & 3] |= uint64_t{1} << disk;
+        }
+
+        const uint8_t* bytes = body();
+        uint64_t last = first_k + count - 1;
+        for (uint64_t k = (block << header.checkpoint_shift) + 1; k <= last; k++) {
+            uint8_t byte = bytes[k - 1];
+            int from = byte & 3, to = (byte >> 2) & 3;
+            if (from > 2 || to > 2 || from == to || pegs[from] == 0) return false;
+            uint64_t top = pegs[from] & (0 - pegs[from]);
+            if (pegs[to] != 0 && (pegs[to] & (0 - pegs[to])) < top) return false;
+            pegs[from] ^= top;
+            pegs[to] |= top;
+        }
+        return true;
+    }
+
+    bool validate() const { return header.moves == 0 || validate(1, header.moves); }
+
+    // Text output, only produced when asked for
+    void format_text(std::ostream& out, uint64_t first_k, uint64_t count, const char labels[3]) const {
+        for (uint64_t k = first_k; k < first_k + count; k++) {
+            hanoi_move m = move(k);
+            out << "Move disk " << m.disk << " from " << labels[m.from] << " to " << labels[m.to] << '\n';
+        }
+    }
+
+    private:
+    void* mapping = nullptr;
+    std::vector<uint8_t> buffer; // file contents on platforms without mmap
+    const uint8_t* data = nullptr;
+    size_t size = 0;
+    hanoi_stream_header header{};
+
+    // The destructor does not run when the constructor throws, so unmap first
+    [[noreturn]] void reject(const std::string& message) {
+#if defined(__unix__) || defined(__APPLE__)
+        if (mapping) munmap(mapping, size);
+        mapping = nullptr;
+#endif
+        throw std::runtime_error(message);
+    }
+};
+
+// Frame-Stewart solution for a tower on 3 to 16 pegs. The top t disks go to a spare peg using
+// every peg, the other n - t go to the destination with one peg fewer, and the top t follow
+// them, with t chosen to minimise the total. Move counts of every subproblem are tabled, so
+// walking to move k skips whole subproblems and any index range can be generated on its own.
+class FrameStewart {
+    public:
+    static constexpr int MAX_PEGS = 16;
+
+    FrameStewart(int n, int pegs) : n(n), pegs(pegs) {
+        if (n < 0 || pegs < 3 || pegs > MAX_PEGS) {
+            throw std::invalid_argument("FrameStewart supports 3 to 16 pegs");
+        }
+        const uint64_t saturated = std::numeric_limits<uint64_t>::max();
+        moves.assign(pegs + 1, std::vector<uint64_t>(n + 1, saturated));
+        split.assign(pegs + 1, std::vector<int>(n + 1, 0));
+        for (int p = 3; p <= pegs; p++) {
+            moves[p][0] = 0;
+            for (int disks = 1; disks <= n; disks++) {
+                for (int t = 1; t < disks; t++) {
+                    uint64_t rest = p == 3 ? (disks - t == 1 ? 1 : saturated) : moves[p - 1][disks - t];
+                    uint64_t total = add_saturated(add_saturated(moves[p][t], moves[p][t]), rest);
+                    if (total < moves[p][disks]) {
+                        moves[p][disks] = total;
+                        split[p][disks] = t;
+                    }
+                }
+                if (disks == 1) moves[p][1] = 1;
+            }
+        }
+        if (moves[pegs][n] == saturated && n > 0) {
+            throw std::overflow_error("move count must stay below 2^64 - 1");
+        }
+    }
+
+    uint64_t size() const { return moves[pegs][n]; }
+
+    // Byte encoding used for k-peg output: from peg in the low nibble, to peg in the high one
+    static uint8_t encode(const hanoi_move& move) {
+        return static_cast<uint8_t>(move.from | (move.to << 4));
+    }
+
+    // Calls visit(move) for moves first_k .. first_k + count - 1 (1-based), pegs 0 .. pegs - 1,
+    // from peg 0 to peg pegs - 1
+    template <typename Visit>
+    void for_each_move(uint64_t first_k, uint64_t count, Visit visit) const {
+        std::array<int, MAX_PEGS> spare{};
+        int spares = 0;
+        for (int peg = 1; peg < pegs - 1; peg++) spare[spares++] = peg;
+        uint64_t skip = first_k - 1;
+        walk(n, 0, 0, pegs - 1, spare, spares, skip, count, visit);
+    }
+
+    void encode_moves(uint64_t first_k, size_t count, uint8_t* out) const {
+        for_each_move(first_k, count, [&](const hanoi_move& move) { *out++ = encode(move); });
+    }
+
+    void encode_moves_parallel(uint64_t first_k, size_t count, uint8_t* out, unsigned threads) const {
+        fill_in_parallel(count, threads, [this, first_k, out](uint64_t offset, uint64_t slice) {
+            encode_moves(first_k + offset, static_cast<size_t>(slice), out + offset);
+        });
+    }
+
+    private:
+    int n;
+    int pegs;
+    std::vector<std::vector<uint64_t>> moves; // moves[p][disks], optimal count with p pegs
+    std::vector<std::vector<int>> split;      // split[p][disks], disks parked on a spare peg
+
+    static uint64_t add_saturated(uint64_t a, uint64_t b) {
+        return a > std::numeric_limits<uint64_t>::max() - b ? std::numeric_limits<uint64_t>::max() : a + b;
+    }
+
+    // Moves disks base + 1 .. base + disks from `from` to `to` with the given spare pegs,
+    // after skipping `skip` moves and stopping once `remaining` reaches zero
+    template <typename Visit>
+    void walk(int disks, int base, int from, int to, const std::array<int, MAX_PEGS>& spare, int spares,
+              uint64_t& skip, uint64_t& remaining, Visit& visit) const {
+        if (disks == 0 || remaining == 0) return;
+        int p = spares + 2;
+        uint64_t total = disks == 1 ? 1 : moves[p][disks];
+        if (skip >= total) {
+            skip -= total;
+            return;
+        }
+        if (disks == 1) {
+            visit(hanoi_move{base + 1, from, to});
+            remaining--;
             return;
         }
-        // 1. Move n-1 disks from source to auxiliary
-        hanoi_tower(n - 1, source, destination, auxiliary);
 
-        // 2. Move the nth disk from source to destination
-        std::cout << "Move disk 1 from {} to {}" << '\n';
+        int top = split[p][disks];
+        int parking = spare[0];
+        std::array<int, MAX_PEGS> with_to = spare, without_parking{};
+        with_to[0] = to;
+        for (int i = 1; i < spares; i++) without_parking[i - 1] = spare[i];
 
-        // 3. Move n-1 disks from auxiliary to destination
-        hanoi_tower(n - 1, auxiliary, source, destination);
+        walk(top, base, from, parking, with_to, spares, skip, remaining, visit);
+        walk(disks - top, base + top, from, to, without_parking, spares - 1, skip, remaining, visit);
+        with_to[0] = from;
+        walk(top, base, parking, to, with_to, spares, skip, remaining, visit);
     }
 };
 
+class solution {
+    public:
+    static void hanoi_tower(int n, char source, char auxiliary, char destination) {
+        const char labels[3] = {source, auxiliary, destination};
+        for (hanoi_move move : HanoiMoves(n)) {
+            std::cout << "Move disk " << move.disk << " from " << labels[move.from]
+                      << " to " << labels[move.to] << '\n';
+        }
+    }
+
+    // The textbook recursion, kept as the reference the move generator is checked against
+    static void hanoi_recursive(int n, int source, int auxiliary, int destination, std::vector<hanoi_move>& moves) {
+        if (n == 0) return;
+        hanoi_recursive(n - 1, source, destination, auxiliary, moves);
+        moves.push_back({n, source, destination});
+        hanoi_recursive(n - 1, auxiliary, source, destination, moves);
+    }
+};
+
+namespace {
+    void run_tests() {
+        std::cout << "Testing.." << '\n';
+
+        // Test: the generator reproduces the recursive solution move for move
+        for (int n = 0; n <= 12; n++) {
+            std::vector<hanoi_move> expected;
+            solution::hanoi_recursive(n, 0, 1, 2, expected);
+            HanoiMoves moves(n);
+            assert(moves.size() == expected.size());
+            size_t i = 0;
+            for (hanoi_move move : moves) {
+                assert(move.disk == expected[i].disk && move.from == expected[i].from && move.to == expected[i].to);
+                i++;
+            }
+            assert(i == expected.size());
+        }
+
+        // Test: replaying moves on real stacks is always legal and state_after matches every step
+        const int n = 16;
+        std::vector<int> stacks[3];
+        for (int disk = n; disk >= 1; disk--) stacks[0].push_back(disk);
+        for (auto it = HanoiMoves(n).begin(); it != HanoiMoves(n).end(); ++it) {
+            hanoi_move move = *it;
+            assert(!stacks[move.from].empty() && stacks[move.from].back() == move.disk);
+            assert(stacks[move.to].empty() || stacks[move.to].back() > move.disk);
+            stacks[move.from].pop_back();
+            stacks[move.to].push_back(move.disk);
+            if (it.index() % 997 == 0) {
+                auto pegs = HanoiMoves::state_after(n, it.index());
+                for (int peg = 0; peg < 3; peg++) {
+                    for (int disk : stacks[peg]) assert(pegs[disk - 1] == peg);
+                }
+            }
+        }
+        assert(stacks[2].size() == n);
+
+        // Test: spot checks on the 64-disk legend without playing it
+        HanoiMoves legend(64);
+        assert(legend.size() == 18446744073709551615ULL);
+        hanoi_move middle = HanoiMoves::move_at(64, uint64_t{1} << 63);
+        assert(middle.disk == 64 && middle.from == 0 && middle.to == 2);
+        auto done = HanoiMoves::state_after(64, legend.size());
+        for (int disk = 1; disk <= 64; disk++) assert(done[disk - 1] == 2);
+        size_t tail = 0;
+        for (auto it = legend.begin_at(legend.size() - 3); it != legend.end(); ++it) tail++;
+        assert(tail == 3);
+        hanoi_move last = HanoiMoves::move_at(64, legend.size());
+        assert(last.disk == 1 && last.to == 2);
+
+        // Test: block-template encoding matches move-by-move encoding, aligned or not
+        for (int disks : {17, 20}) {
+            for (uint64_t first : {1ULL, 2ULL, 65535ULL, 65536ULL, 65537ULL, 200001ULL}) {
+                size_t count = static_cast<size_t>(std::min<uint64_t>(300000, HanoiMoves(disks).size() - first + 1));
+                std::vector<uint8_t> fast(count);
+                HanoiStreamWriter::encode_moves(disks, first, count, fast.data());
+                for (size_t i = 0; i < count; i++) {
+                    assert(fast[i] == HanoiStreamWriter::encode(HanoiMoves::move_at(disks, first + i)));
+                }
+            }
+        }
+
+        // Test: parallel slices produce exactly the sequential stream
+        {
+            const int disks = 22;
+            size_t count = static_cast<size_t>(HanoiMoves(disks).size());
+            std::vector<uint8_t> sequential(count), parallel(count);
+            HanoiStreamWriter::encode_moves(disks, 1, count, sequential.data());
+            for (unsigned threads : {2u, 3u, 8u}) {
+                HanoiStreamWriter::encode_moves_parallel(disks, 1, count, parallel.data(), threads);
+                assert(parallel == sequential);
+            }
+        }
+
+        // Test: Frame-Stewart counts, legality on k pegs, and index-range generation
+        {
+            const uint64_t four_pegs[] = {0, 1, 3, 5, 9, 13, 17, 25, 33, 41, 49, 65};
+            for (int disks = 0; disks <= 11; disks++) {
+                assert(FrameStewart(disks, 4).size() == four_pegs[disks]);
+            }
+            assert(FrameStewart(10, 3).size() == 1023);
+
+            for (auto [disks, pegs] : std::vector<std::pair<int, int>>{{10, 3}, {12, 4}, {15, 5}, {20, 7}}) {
+                FrameStewart puzzle(disks, pegs);
+                std::vector<std::vector<int>> stacks(pegs);
+                for (int disk = disks; disk >= 1; disk--) stacks[0].push_back(disk);
+                std::vector<uint8_t> encoded;
+                puzzle.for_each_move(1, puzzle.size(), [&](const hanoi_move& move) {
+                    assert(!stacks[move.from].empty() && stacks[move.from].back() == move.disk);
+                    assert(stacks[move.to].empty() || stacks[move.to].back() > move.disk);
+                    stacks[move.from].pop_back();
+                    stacks[move.to].push_back(move.disk);
+                    encoded.push_back(FrameStewart::encode(move));
+                });
+                assert(static_cast<int>(stacks[pegs - 1].size()) == disks && encoded.size() == puzzle.size());
+
+                std::vector<uint8_t> parallel(encoded.size());
+                puzzle.encode_moves_parallel(1, parallel.size(), parallel.data(), 5);
+                assert(parallel == encoded);
+                std::vector<uint8_t> middle(7);
+                puzzle.encode_moves(puzzle.size() / 2, middle.size(), middle.data());
+                assert(std::equal(middle.begin(), middle.end(), encoded.begin() + (puzzle.size() / 2 - 1)));
+            }
+        }
+
+        // Test: a stream round-trips through the file, validates, and rejects a corrupted move
+        {
+            std::string path = (std::filesystem::temp_directory_path() / "hanoi_stream_test.bin").string();
+            HanoiStreamWriter::write(path, 21);
+            {
+                HanoiStreamReader reader(path);
+                assert(reader.info().moves == (1u << 21) - 1 && reader.info().checkpoints == 2);
+                assert(reader.validate() && reader.validate(1500000, 1000));
+                for (uint64_t k : {1ULL, 2ULL, 3ULL, 1048576ULL, 2097151ULL}) {
+                    hanoi_move expected = HanoiMoves::move_at(21, k), actual = reader.move(k);
+                    assert(actual.disk == expected.disk && actual.from == expected.from && actual.to == expected.to);
+                }
+                std::ostringstream text;
+                const char labels[3] = {'A', 'B', 'C'};
+                reader.format_text(text, 1, 2, labels);
+                assert(text.str() == "Move disk 1 from A to C\nMove disk 2 from A to B\n");
+            }
+            std::fstream corrupt(path, std::ios::in | std::ios::out | std::ios::binary);
+            corrupt.seekp(sizeof(hanoi_stream_header) + 5);
+            corrupt.put(static_cast<char>(HanoiStreamWriter::encode({1, 2, 0})));
+            corrupt.close();
+            assert(!HanoiStreamReader(path).validate());
+            {
+                HanoiStreamReader reader(path);
+                uint64_t moves = reader.info().moves;
+                assert(!reader.validate(0, 1) && !reader.validate(moves, 2) && reader.validate(moves, 1));
+                bool thrown = false;
+                try {
+                    reader.move(moves + 1);
+                } catch (const std::out_of_range&) {
+                    thrown = true;
+                }
+                assert(thrown);
+            }
+
+            // A header claiming more than 64 disks is refused before anything shifts by it
+            corrupt.open(path, std::ios::in | std::ios::out | std::ios::binary);
+            uint32_t disks = 65;
+            corrupt.seekp(offsetof(hanoi_stream_header, disks));
+            corrupt.write(reinterpret_cast<const char*>(&disks), sizeof(disks));
+            corrupt.close();
+            bool rejected = false;
+            try {
+                HanoiStreamReader reader(path);
+            } catch (const std::runtime_error&) {
+                rejected = true;
+            }
+            assert(rejected);
+            std::filesystem::remove(path);
+        }
+
+        std::cout << "All tests passed!" << '\n';
+    }
+
+    // Stream throughput against per-move formatted output
+    void run_benchmarks(int n) {
+        std::string path = (std::filesystem::temp_directory_path() / "hanoi_stream_bench.bin").string();
+        auto start = std::chrono::steady_clock::now();
+        HanoiStreamWriter::write(path, n);
+        std::chrono::duration<double> written = std::chrono::steady_clock::now() - start;
+        uint64_t moves = HanoiMoves(n).size();
+
+        start = std::chrono::steady_clock::now();
+        HanoiStreamReader reader(path);
+        uint64_t histogram[16] = {};
+        const uint8_t* body = reader.body();
+        for (uint64_t i = 0; i < moves; i++) histogram[body[i] & 15]++;
+        std::chrono::duration<double> scanned = std::chrono::steady_clock::now() - start;
+        uint64_t scanned_moves = 0;
+        for (uint64_t count : histogram) scanned_moves += count;
+
+        start = std::chrono::steady_clock::now();
+        bool valid = reader.validate();
+        std::chrono::duration<double> validated = std::chrono::steady_clock::now() - start;
+
+        const int text_disks = 20;
+        std::ostringstream sink;
+        start = std::chrono::steady_clock::now();
+        for (hanoi_move move : HanoiMoves(text_disks)) {
+            sink << "Move disk " << move.disk << " from " << move.from << " to " << move.to << '\n';
+        }
+        std::chrono::duration<double> formatted = std::chrono::steady_clock::now() - start;
+
+        std::cout << "n=" << n << " (" << moves << " moves): write " << moves / written.count() / 1e6
+                  << " M moves/s, scan " << scanned_moves / scanned.count() / 1e6 << " M moves/s, validate "
+                  << moves / validated.count() / 1e6 << " M moves/s (" << (valid ? "valid" : "INVALID") << ")\n";
+        std::cout << "Formatted text for n=" << text_disks << ": " << HanoiMoves(text_disks).size() / formatted.count() / 1e6
+                  << " M moves/s\n";
+        std::filesystem::remove(path);
+    }
+
+    // Moves per second against thread count, for the 3-peg bit trick and a 4-peg Frame-Stewart
+    void run_scaling_benchmark(int n) {
+        unsigned max_threads = std::max(std::thread::hardware_concurrency(), 1u);
+        size_t count = static_cast<size_t>(HanoiMoves(n).size());
+        std::vector<uint8_t> buffer(count);
+        FrameStewart four_pegs(253, 4); // (21 * 2^22) + 1 moves
+        std::vector<uint8_t> four_peg_buffer(static_cast<size_t>(four_pegs.size()));
+
+        std::cout << "Parallel generation, " << count << " moves (3 pegs) and "
+                  << four_pegs.size() << " moves (4 pegs, 253 disks):\n";
+        for (unsigned threads = 1; threads <= max_threads; threads++) {
+            auto start = std::chrono::steady_clock::now();
+            HanoiStreamWriter::encode_moves_parallel(n, 1, count, buffer.data(), threads);
+            std::chrono::duration<double> three = std::chrono::steady_clock::now() - start;
+            start = std::chrono::steady_clock::now();
+            four_pegs.encode_moves_parallel(1, four_peg_buffer.size(), four_peg_buffer.data(), threads);
+            std::chrono::duration<double> four = std::chrono::steady_clock::now() - start;
+            std::cout << "  " << threads << " thread(s): " << count / three.count() / 1e6 << " M moves/s (3 pegs), "
+                      << four_peg_buffer.size() / four.count() / 1e6 << " M moves/s (4 pegs)\n";
+        }
+    }
+}
+
 int main(int argc, char* argv[]) {
     // set the disks amount
     int n = 12;
@@ -50,4 +755,12 @@ int main(int argc, char* argv[]) {
                           'A', // source peg
                           'B', // axiliary peg
                           'C'); // destination peg
+
+    run_tests();
+
+    // pass --bench [disks] to time the binary move stream (default 26 disks)
+    if (argc > 1 && std::string(argv[1]) == "--bench") {
+        run_benchmarks(argc > 2 ? std::stoi(argv[2]) : 26);
+        run_scaling_benchmark(argc > 2 ? std::stoi(argv[2]) : 26);
+    }
 }
@@ -20,15 +20,211 @@ Dev Notes:
 finally updated the code to have test cases, no comments for you tho
 */
 #include <iostream>
+#include <cstdint>
+#include <cinttypes>
+#include <chrono>
+#include <string>
+#include <algorithm>
+#include <vector>
+#include <thread>
+#include <list>
+#include <unordered_map>
+#include <random>
+#if defined(__BMI2__) || defined(__AVX2__)
+#include <immintrin.h>
+#endif
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
 using namespace std;
 
 class solution {
 public:
+    static constexpr uint32_t WORDS_PER_BLOCK = 8;
+    static constexpr uint32_t PEOPLE_PER_BLOCK = WORDS_PER_BLOCK * 64;
+
     static int josephus_prob(const int n, const int k) {
+        return static_cast<int>(josephus_survivor(static_cast<uint64_t>(n), static_cast<uint64_t>(k)));
+    }
+
+    // The original recursion, n levels deep; kept as the reference the fast solver is checked against
+    static int josephus_recursive(const int n, const int k) {
         if (n == 1) {return 0;}
-        return (josephus_prob(n - 1, k) + k) % n;
+        return (josephus_recursive(n - 1, k) + k) % n;
+    }
+
+    // 0-based position of the survivor among n >= 1 people when every k-th (k >= 1) is removed
+    static uint64_t josephus_survivor(uint64_t n, uint64_t k) {
+        if (k == 1) {return n - 1;}
+        if (k == 2) {return josephus_k2(n);}
+        return josephus_skip(n, k);
+    }
+
+    // Closed form for k = 2: with n = 2^m + l, the survivor is 2l
+    static uint64_t josephus_k2(uint64_t n) {
+        uint64_t highest = n;
+        for (int shift = 1; shift < 64; shift <<= 1) {highest |= highest >> shift;}
+        highest -= highest >> 1;
+        return 2 * (n - highest);
+    }
+
+    // Iterative J(s + 1) = (J(s) + k) % (s + 1), growing the circle many people at a time:
+    // as long as J + k stays below the circle size nothing wraps, so the next
+    // (s - 1 - J) / (k - 1) additions collapse into a single J += x * k.
+    // The circle grows by a factor of about k / (k - 1) per wrap, O(k log n) steps overall.
+    static uint64_t josephus_skip(uint64_t n, uint64_t k) {
+        uint64_t survivor = 0;
+        uint64_t size = 1;
+        while (size < n) {
+            uint64_t steps = (size - 1 - survivor) / (k - 1);
+            if (steps == 0) {
+                size++;
+                survivor = (survivor + k % size) % size;
+                continue;
+            }
+            steps = std::min(steps, n - size);
+            survivor += steps * k;
+            size += steps;
+        }
+        return survivor;
     }
     
+    // Elimination order (0-based positions) written into order[0..n), the last entry being the survivor.
+    // Alive people are bits, 512 to a cache line of eight words, and a Fenwick tree counts the
+    // alive bits per line. "k-th person still alive" is a binary-lifting descent over n / 512
+    // counters (small enough to stay in cache) followed by a scan of one line: O(n log n)
+    // overall instead of O(nk) for a circular list.
+    static void josephus_permutation(uint32_t n, uint32_t k, uint32_t* order, unsigned threads = 1) {
+        if (n == 0) {return;}
+        // In 64 bits: n close to 2^32 would wrap the round-up to zero blocks
+        const uint32_t blocks = static_cast<uint32_t>((uint64_t{n} + PEOPLE_PER_BLOCK - 1) / PEOPLE_PER_BLOCK);
+        std::vector<uint32_t> tree(static_cast<size_t>(blocks) + 1);
+        std::vector<uint64_t> alive(static_cast<size_t>(blocks) * WORDS_PER_BLOCK);
+        build_alive_index(tree.data(), alive.data(), blocks, n, threads);
+
+        uint32_t top = 1;
+        while (top <= blocks / 2) {top <<= 1;}
+
+        uint64_t position = 0;
+        for (uint32_t remaining = n; remaining > 0; remaining--) {
+            position = (position + k - 1) % remaining;
+            // Binary lifting from the highest power of two, kept branch-free since the
+            // direction taken at each level is a coin flip for the predictor
+            uint32_t rank = static_cast<uint32_t>(position) + 1;
+            uint32_t block = 0;
+            for (uint32_t step = top; step != 0; step >>= 1) {
+                uint32_t next = block + step;
+                uint32_t count = next <= blocks ? tree[next] : rank;
+                bool skip = count < rank;
+                block = skip ? next : block;
+                rank -= skip ? count : 0;
+            }
+            for (uint32_t i = block + 1; i <= blocks; i += i & (0u - i)) {tree[i]--;}
+
+            uint64_t* words = &alive[static_cast<size_t>(block) * WORDS_PER_BLOCK];
+            uint32_t word = 0;
+            for (uint32_t count; (count = static_cast<uint32_t>(popcount64(words[word]))) < rank; word++) {rank -= count;}
+            int bit = select64(words[word], rank);
+            words[word] &= ~(1ULL << bit);
+            *order++ = block * PEOPLE_PER_BLOCK + word * 64 + static_cast<uint32_t>(bit);
+        }
+    }
+
+    static std::vector<uint32_t> josephus_permutation(uint32_t n, uint32_t k) {
+        std::vector<uint32_t> order(n);
+        josephus_permutation(n, k, order.data());
+        return order;
+    }
+
+    // With every line full, Fenwick node i covers lowbit(i) lines of 512 people each, so the
+    // bulk build needs no prefix pass and splits freely across threads; only the last,
+    // partial line and the nodes above it are corrected afterwards. Each thread gets at least
+    // blocks_per_thread lines, so small tables stay on one thread.
+    static void build_alive_index(uint32_t* tree, uint64_t* alive, uint32_t blocks, uint32_t n, unsigned threads,
+                                  uint64_t blocks_per_thread = 16384) {
+        tree[0] = 0;
+        auto fill = [tree, alive](uint64_t begin, uint64_t end) {
+            for (uint64_t i = begin; i < end; i++) {tree[i] = static_cast<uint32_t>(PEOPLE_PER_BLOCK * (i & (0 - i)));}
+            std::fill(alive + (begin - 1) * WORDS_PER_BLOCK, alive + (end - 1) * WORDS_PER_BLOCK, ~0ULL);
+        };
+        const uint64_t total = static_cast<uint64_t>(blocks) + 1;
+        threads = std::max(1u, std::min<unsigned>(threads, static_cast<unsigned>(std::min<uint64_t>(total / std::max<uint64_t>(blocks_per_thread, 1) + 1, 64))));
+        if (threads == 1) {
+            fill(1, total);
+        } else {
+            std::vector<std::thread> workers;
+            const uint64_t chunk = (total + threads - 1) / threads;
+            for (unsigned t = 0; t < threads; t++) {
+                uint64_t begin = std::max<uint64_t>(1, t * chunk);
+                uint64_t end = std::min(total, (t + 1) * chunk);
+                if (begin < end) {workers.emplace_back(fill, begin, end);}
+            }
+            for (auto& worker : workers) {worker.join();}
+        }
+        // Full lines can hold 2^32 people, one more than uint32_t counts; tree entries are exact
+        // modulo 2^32, which is enough since every true count is at most n
+        const uint64_t capacity = uint64_t{blocks} * PEOPLE_PER_BLOCK;
+        const uint32_t missing = static_cast<uint32_t>(capacity - n);
+        for (uint64_t i = n; i < capacity; i++) {alive[i / 64] &= ~(1ULL << (i % 64));}
+        for (uint32_t i = blocks; missing != 0 && i <= blocks; i += i & (0u - i)) {tree[i] -= missing;}
+    }
+
+    // Position of the rank-th (1-based) set bit of word
+    static int select64(uint64_t word, uint32_t rank) {
+#if defined(__BMI2__)
+        return ctz64(_pdep_u64(1ULL << (rank - 1), word));
+#else
+        // Broadword: per-byte counts, then a multiply turns them into running totals per byte
+        uint64_t bytes = word - ((word >> 1) & 0x5555555555555555ULL);
+        bytes = (bytes & 0x3333333333333333ULL) + ((bytes >> 2) & 0x3333333333333333ULL);
+        bytes = (bytes + (bytes >> 4)) & 0x0F0F0F0F0F0F0F0FULL;
+        const uint64_t totals = bytes * 0x0101010101010101ULL;
+        int base = 0;
+        while (((totals >> base) & 0xFF) < rank) {base += 8;}
+        if (base != 0) {rank -= static_cast<uint32_t>((totals >> (base - 8)) & 0xFF);}
+        for (word >>= base;; word >>= 1, base++) {
+            if ((word & 1) && --rank == 0) {return base;}
+        }
+#endif
+    }
+
+    static int popcount64(uint64_t x) {
+#if defined(_MSC_VER)
+        return static_cast<int>(__popcnt64(x));
+#elif defined(__POPCNT__)
+        return __builtin_popcountll(x);
+#else
+        // Without the instruction the builtin becomes a library call; SWAR stays inline
+        x = x - ((x >> 1) & 0x5555555555555555ULL);
+        x = (x & 0x3333333333333333ULL) + ((x >> 2) & 0x3333333333333333ULL);
+        x = (x + (x >> 4)) & 0x0F0F0F0F0F0F0F0FULL;
+        return static_cast<int>((x * 0x0101010101010101ULL) >> 56);
+#endif
+    }
+
+    static int ctz64(uint64_t x) {
+#if defined(_MSC_VER)
+        unsigned long index;
+        _BitScanForward64(&index, x);
+        return static_cast<int>(index);
+#else
+        return __builtin_ctzll(x);
+#endif
+    }
+
+    // Naive vector-erase elimination, O(n^2); only used to check the Fenwick version
+    static std::vector<uint32_t> josephus_permutation_naive(uint32_t n, uint32_t k) {
+        std::vector<uint32_t> circle(n), order;
+        for (uint32_t i = 0; i < n; i++) {circle[i] = i;}
+        size_t position = 0;
+        while (!circle.empty()) {
+            position = (position + k - 1) % circle.size();
+            order.push_back(circle[position]);
+            circle.erase(circle.begin() + position);
+        }
+        return order;
+    }
+
     static void test_cases(int test_number, int k, int length, int expected) {
         int actual = josephus_prob(length, k) + 1;
         
@@ -42,14 +238,408 @@ public:
             printf("Test %d failed: k=%d, length=%d\n", test_number, k, length);
         }
     }
+
+    // Fast solver against the recursion for every small (n, k), plus the huge-n cases it exists for
+    static void test_fast_solver(int test_number) {
+        bool passed = true;
+        for (int n = 1; n <= 1000 && passed; n++) {
+            for (int k = 1; k <= 60; k++) {
+                if (josephus_survivor(n, k) != static_cast<uint64_t>(josephus_recursive(n, k))) {
+                    printf("\nTest %d mismatch: n=%d, k=%d\n", test_number, n, k);
+                    passed = false;
+                    break;
+                }
+            }
+        }
+        const uint64_t huge = 1000000000000000000ULL;
+        passed = passed && josephus_skip(huge, 2) == josephus_k2(huge);
+        passed = passed && josephus_k2(huge) == 2 * (huge - (1ULL << 59));
+        passed = passed && josephus_survivor(huge, 1) == huge - 1;
+        printf("\nTest %d %s: fast solver matches the recursion\n", test_number, passed ? "passed" : "failed");
+    }
+
+    // Fenwick permutation against the naive elimination, including the Josephus legend itself
+    static void test_permutation(int test_number) {
+        bool passed = true;
+        for (uint32_t n = 1; n <= 200 && passed; n++) {
+            for (uint32_t k = 1; k <= 25; k++) {
+                std::vector<uint32_t> order = josephus_permutation(n, k);
+                if (order != josephus_permutation_naive(n, k) || order.back() != josephus_survivor(n, k)) {
+                    printf("\nTest %d mismatch: n=%u, k=%u\n", test_number, n, k);
+                    passed = false;
+                    break;
+                }
+            }
+        }
+        std::vector<uint32_t> legend = josephus_permutation(41, 3);
+        passed = passed && legend[0] == 2 && legend[1] == 5 && legend[39] == 15 && legend[40] == 30;
+
+        // The threaded bulk build, with a threshold low enough to split these sizes, against one thread
+        for (uint32_t n : {1u, 511u, 4096u, 100000u, 262144u}) {
+            const uint32_t blocks = static_cast<uint32_t>((uint64_t{n} + PEOPLE_PER_BLOCK - 1) / PEOPLE_PER_BLOCK);
+            std::vector<uint32_t> tree(static_cast<size_t>(blocks) + 1), parallel_tree(tree.size());
+            std::vector<uint64_t> alive(static_cast<size_t>(blocks) * WORDS_PER_BLOCK), parallel_alive(alive.size());
+            build_alive_index(tree.data(), alive.data(), blocks, n, 1);
+            for (unsigned threads : {2u, 3u, 4u}) {
+                build_alive_index(parallel_tree.data(), parallel_alive.data(), blocks, n, threads, 4);
+                passed = passed && parallel_tree == tree && parallel_alive == alive;
+            }
+        }
+        printf("\nTest %d %s: elimination order matches the naive simulation\n", test_number, passed ? "passed" : "failed");
+    }
+
+    static void benchmark_permutation(uint32_t n, uint32_t k, unsigned threads) {
+        std::vector<uint32_t> order(n);
+        auto start = chrono::steady_clock::now();
+        josephus_permutation(n, k, order.data(), threads);
+        double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+        printf("permutation n=%u k=%u threads=%u: %.3f s (survivor %u)\n", n, k, threads, seconds, order[n - 1] + 1);
+    }
+
+    // Recursion against the skip-ahead solver over n and k, then the skip-ahead alone up to 10^18
+    static void benchmark() {
+        printf("\n%-20s %-6s %-16s %-16s\n", "n", "k", "recursive (us)", "fast (us)");
+        for (int n : {1000, 10000, 100000}) {
+            for (int k : {2, 3, 100}) {
+                auto start = chrono::steady_clock::now();
+                int expected = josephus_recursive(n, k);
+                double recursive_us = chrono::duration<double, micro>(chrono::steady_clock::now() - start).count();
+                start = chrono::steady_clock::now();
+                uint64_t actual = josephus_survivor(n, k);
+                double fast_us = chrono::duration<double, micro>(chrono::steady_clock::now() - start).count();
+                printf("%-20d %-6d %-16.2f %-16.2f%s\n", n, k, recursive_us, fast_us,
+                       actual == static_cast<uint64_t>(expected) ? "" : " MISMATCH");
+            }
+        }
+        for (uint64_t n : {1000000000ULL, 1000000000000ULL, 1000000000000000000ULL}) {
+            for (uint64_t k : {3ULL, 10ULL, 1000ULL}) {
+                auto start = chrono::steady_clock::now();
+                uint64_t survivor = josephus_survivor(n, k);
+                double fast_us = chrono::duration<double, micro>(chrono::steady_clock::now() - start).count();
+                printf("%-20" PRIu64 " %-6" PRIu64 " %-16s %-16.2f(survivor %" PRIu64 ")\n", n, k, "-", fast_us, survivor + 1);
+            }
+        }
+    }
 };
-int main() {
+
+struct josephus_query {
+    uint32_t n;    // people in the circle, >= 1
+    uint32_t k;    // every k-th is removed, >= 1
+};
+
+// One k's survivor table being grown: table[s] = J(s) is already filled for 1 <= s <= from,
+// and extend_tables fills from + 1 .. to
+struct josephus_lane {
+    uint32_t k;
+    uint32_t* table;
+    uint32_t from;
+    uint32_t to;
+};
+
+// Answers many (n, k) pairs at once. Queries are grouped by k, and each k gets one table
+// J(1..n_max) in uint32 that is built once and answered by lookup; up to eight tables are grown
+// side by side, one k per AVX2 lane. Tables stay cached between calls under an LRU memory cap.
+// A k with too few queries to pay for its table, or whose table would not fit, goes to the
+// O(k log n) solver instead, which is what keeps sparse sweeps over huge n cheap.
+class JosephusBatch {
+public:
+    static constexpr int LANES = 8;
+
+    explicit JosephusBatch(size_t memory_cap = size_t{256} << 20) : memory_cap(memory_cap) {}
+
+    size_t cached_bytes() const {return used_bytes;}
+    size_t cached_tables() const {return tables.size();}
+
+    // 0-based survivor of every query written into survivors[0..count)
+    void solve(const josephus_query* queries, size_t count, uint32_t* survivors) {
+        std::vector<uint32_t> by_k(count);
+        for (size_t i = 0; i < count; i++) {by_k[i] = static_cast<uint32_t>(i);}
+        std::sort(by_k.begin(), by_k.end(), [queries](uint32_t a, uint32_t b) {return queries[a].k < queries[b].k;});
+
+        std::vector<pending_table> pending;
+        for (size_t begin = 0, end; begin < count; begin = end) {
+            const uint32_t k = queries[by_k[begin]].k;
+            uint32_t n_max = 0;
+            for (end = begin; end < count && queries[by_k[end]].k == k; end++) {
+                n_max = std::max(n_max, queries[by_k[end]].n);
+            }
+
+            auto cached = index.find(k);
+            if (cached != index.end() && cached->second->survivors.size() > n_max) {
+                tables.splice(tables.begin(), tables, cached->second);
+                answer(queries, &by_k[begin], end - begin, cached->second->survivors.data(), survivors);
+                continue;
+            }
+            const uint32_t have = cached != index.end() ? static_cast<uint32_t>(cached->second->survivors.size() - 1) : 0;
+            const uint64_t table_bytes = (static_cast<uint64_t>(n_max) + 1) * sizeof(uint32_t);
+            const uint64_t direct_cost = (end - begin) * std::min<uint64_t>(n_max, static_cast<uint64_t>(k) * bit_width(n_max / k + 1));
+            if (k <= 2 || table_bytes > memory_cap || direct_cost < n_max - have) {
+                for (size_t i = begin; i < end; i++) {
+                    const josephus_query& query = queries[by_k[i]];
+                    survivors[by_k[i]] = static_cast<uint32_t>(solution::josephus_survivor(query.n, query.k));
+                }
+                continue;
+            }
+
+            pending_table table{{k, {}}, n_max, begin, end};
+            if (cached != index.end()) {
+                table.entry.survivors = std::move(cached->second->survivors);
+                used_bytes -= table.entry.survivors.size() * sizeof(uint32_t);
+                tables.erase(cached->second);
+                index.erase(cached);
+            }
+            pending.push_back(std::move(table));
+        }
+
+        // Similar sizes in one group keep the lanes busy until the shortest table is done
+        std::sort(pending.begin(), pending.end(), [](const pending_table& a, const pending_table& b) {return a.n_max > b.n_max;});
+        for (size_t group = 0; group < pending.size(); group += LANES) {
+            josephus_lane lanes[LANES];
+            const int width = static_cast<int>(std::min<size_t>(LANES, pending.size() - group));
+            for (int lane = 0; lane < width; lane++) {
+                pending_table& table = pending[group + lane];
+                std::vector<uint32_t>& survivors_of_k = table.entry.survivors;
+                const uint32_t from = survivors_of_k.empty() ? 1 : static_cast<uint32_t>(survivors_of_k.size() - 1);
+                survivors_of_k.resize(static_cast<size_t>(table.n_max) + 1);
+                survivors_of_k[1] = 0;
+                lanes[lane] = {table.entry.k, survivors_of_k.data(), from, table.n_max};
+            }
+            extend_tables(lanes, width);
+            for (int lane = 0; lane < width; lane++) {
+                pending_table& table = pending[group + lane];
+                answer(queries, &by_k[table.begin], table.end - table.begin, table.entry.survivors.data(), survivors);
+                remember(std::move(table.entry));
+            }
+        }
+    }
+
+    // Grows every lane's table with J(s) = (J(s - 1) + k) % s. Once s >= k the sum stays below
+    // 2s, so the modulo is a single conditional subtract, taken branch-free as
+    // min(J + k, J + k - s) in unsigned arithmetic. Steps before that, and sizes of 2^31 and up
+    // where the sum could overflow 32 bits, use a real modulo per lane.
+    static void extend_tables(josephus_lane* lanes, int count) {
+        uint64_t begin = 0, end = UINT32_MAX;
+        for (int lane = 0; lane < count; lane++) {
+            begin = std::max<uint64_t>(begin, std::max<uint64_t>(lanes[lane].from + 1ULL, lanes[lane].k));
+            end = std::min<uint64_t>(end, lanes[lane].to);
+        }
+        end = std::min<uint64_t>(end, INT32_MAX);
+        if (begin > end) {begin = end = UINT32_MAX;}
+
+        for (int lane = 0; lane < count; lane++) {
+            const josephus_lane& l = lanes[lane];
+            extend_scalar(l, l.from + uint64_t{1}, std::min<uint64_t>(l.to, begin - 1));
+        }
+        if (begin == UINT32_MAX) {return;}
+
+        uint64_t s = begin;
+#if defined(__AVX2__)
+        alignas(32) uint32_t ks[LANES] = {}, state[LANES] = {};
+        for (int lane = 0; lane < LANES; lane++) {
+            ks[lane] = lane < count ? lanes[lane].k : 1;
+            state[lane] = lane < count ? lanes[lane].table[begin - 1] : 0;
+        }
+        const __m256i k = _mm256_load_si256(reinterpret_cast<const __m256i*>(ks));
+        __m256i survivor = _mm256_load_si256(reinterpret_cast<const __m256i*>(state));
+        // Eight steps at a time, then an 8x8 transpose turns step rows into per-k runs
+        for (; s + LANES - 1 <= end; s += LANES) {
+            __m256i rows[LANES];
+            for (int step = 0; step < LANES; step++) {
+                __m256i size = _mm256_set1_epi32(static_cast<int>(s + step));
+                __m256i sum = _mm256_add_epi32(survivor, k);
+                survivor = _mm256_min_epu32(sum, _mm256_sub_epi32(sum, size));
+                rows[step] = survivor;
+            }
+            transpose8(rows);
+            for (int lane = 0; lane < count; lane++) {
+                _mm256_storeu_si256(reinterpret_cast<__m256i*>(lanes[lane].table + s), rows[lane]);
+            }
+        }
+#endif
+        for (int lane = 0; lane < count; lane++) {
+            const josephus_lane& l = lanes[lane];
+            uint32_t survivor = l.table[s - 1];
+            for (uint64_t size = s; size <= end; size++) {
+                uint32_t sum = survivor + l.k;
+                survivor = std::min(sum, static_cast<uint32_t>(sum - size));
+                l.table[size] = survivor;
+            }
+            extend_scalar(l, end + 1, l.to);
+        }
+    }
+
+private:
+    struct table_entry {
+        uint32_t k;
+        std::vector<uint32_t> survivors;    // survivors[s] = J(s) for 1 <= s < size(); [0] unused
+    };
+
+    struct pending_table {
+        table_entry entry;
+        uint32_t n_max;
+        size_t begin, end;                  // this k's queries in the sorted order
+    };
+
+    size_t memory_cap;
+    size_t used_bytes = 0;
+    std::list<table_entry> tables;          // most recently used first
+    std::unordered_map<uint32_t, std::list<table_entry>::iterator> index;
+
+    static void answer(const josephus_query* queries, const uint32_t* which, size_t count, const uint32_t* table, uint32_t* survivors) {
+        for (size_t i = 0; i < count; i++) {survivors[which[i]] = table[queries[which[i]].n];}
+    }
+
+    static void extend_scalar(const josephus_lane& lane, uint64_t first, uint64_t last) {
+        uint64_t survivor = first >= 2 ? lane.table[first - 1] : 0;
+        for (uint64_t size = first; size <= last; size++) {
+            survivor = (survivor + lane.k) % size;
+            lane.table[size] = static_cast<uint32_t>(survivor);
+        }
+    }
+
+    static int bit_width(uint64_t x) {
+        int width = 0;
+        for (; x != 0; x >>= 1) {width++;}
+        return width;
+    }
+
+    void remember(table_entry&& entry) {
+        used_bytes += entry.survivors.size() * sizeof(uint32_t);
+        const uint32_t k = entry.k;
+        tables.push_front(std::move(entry));
+        index[k] = tables.begin();
+        while (used_bytes > memory_cap && tables.size() > 1) {
+            used_bytes -= tables.back().survivors.size() * sizeof(uint32_t);
+            index.erase(tables.back().k);
+            tables.pop_back();
+        }
+    }
+
+#if defined(__AVX2__)
+    static void transpose8(__m256i* rows) {
+        __m256i t0 = _mm256_unpacklo_epi32(rows[0], rows[1]), t1 = _mm256_unpackhi_epi32(rows[0], rows[1]);
+        __m256i t2 = _mm256_unpacklo_epi32(rows[2], rows[3]), t3 = _mm256_unpackhi_epi32(rows[2], rows[3]);
+        __m256i t4 = _mm256_unpacklo_epi32(rows[4], rows[5]), t5 = _mm256_unpackhi_epi32(rows[4], rows[5]);
+        __m256i t6 = _mm256_unpacklo_epi32(rows[6], rows[7]), t7 = _mm256_unpackhi_epi32(rows[6], rows[7]);
+        __m256i u0 = _mm256_unpacklo_epi64(t0, t2), u1 = _mm256_unpackhi_epi64(t0, t2);
+        __m256i u2 = _mm256_unpacklo_epi64(t1, t3), u3 = _mm256_unpackhi_epi64(t1, t3);
+        __m256i u4 = _mm256_unpacklo_epi64(t4, t6), u5 = _mm256_unpackhi_epi64(t4, t6);
+        __m256i u6 = _mm256_unpacklo_epi64(t5, t7), u7 = _mm256_unpackhi_epi64(t5, t7);
+        rows[0] = _mm256_permute2x128_si256(u0, u4, 0x20);
+        rows[1] = _mm256_permute2x128_si256(u1, u5, 0x20);
+        rows[2] = _mm256_permute2x128_si256(u2, u6, 0x20);
+        rows[3] = _mm256_permute2x128_si256(u3, u7, 0x20);
+        rows[4] = _mm256_permute2x128_si256(u0, u4, 0x31);
+        rows[5] = _mm256_permute2x128_si256(u1, u5, 0x31);
+        rows[6] = _mm256_permute2x128_si256(u2, u6, 0x31);
+        rows[7] = _mm256_permute2x128_si256(u3, u7, 0x31);
+    }
+#endif
+};
+
+namespace {
+    // Batch answers against the single-query solver, across cache hits, table extension and eviction
+    void test_batch(int test_number) {
+        std::mt19937 rng(41);
+        std::vector<josephus_query> queries(20000);
+        for (josephus_query& query : queries) {
+            query.k = static_cast<uint32_t>(1 + rng() % 70);
+            query.n = static_cast<uint32_t>(1 + rng() % (query.k % 3 == 0 ? 50000 : 300));
+        }
+        queries.push_back({1, 1000});
+        queries.push_back({999, 1000});
+        queries.push_back({4000000000u, 3});
+
+        bool passed = true;
+        JosephusBatch batch(size_t{1} << 20);
+        std::vector<uint32_t> survivors(queries.size());
+        for (int round = 0; round < 3 && passed; round++) {
+            batch.solve(queries.data(), queries.size(), survivors.data());
+            for (size_t i = 0; i < queries.size(); i++) {
+                if (survivors[i] != solution::josephus_survivor(queries[i].n, queries[i].k)) {
+                    printf("\nTest %d mismatch: n=%u, k=%u\n", test_number, queries[i].n, queries[i].k);
+                    passed = false;
+                    break;
+                }
+            }
+            // Grow every n so the next round extends the cached tables
+            for (josephus_query& query : queries) {query.n = static_cast<uint32_t>(std::min<uint64_t>(UINT32_MAX, query.n + query.n / 2));}
+        }
+        passed = passed && batch.cached_bytes() <= (size_t{1} << 20);
+
+        // Lanes of unequal length and start, straight against the recursion
+        std::vector<std::vector<uint32_t>> tables(5);
+        josephus_lane lanes[5];
+        for (int lane = 0; lane < 5; lane++) {
+            tables[lane].assign(2001 + 37 * lane, 0);
+            lanes[lane] = {static_cast<uint32_t>(3 + 50 * lane), tables[lane].data(), 1, static_cast<uint32_t>(2000 + 37 * lane)};
+        }
+        JosephusBatch::extend_tables(lanes, 5);
+        for (int lane = 0; lane < 5 && passed; lane++) {
+            for (uint32_t n = 1; n <= lanes[lane].to; n++) {
+                passed = passed && tables[lane][n] == static_cast<uint32_t>(solution::josephus_recursive(n, lanes[lane].k));
+            }
+        }
+        printf("\nTest %d %s: batch answers match the single-query solver\n", test_number, passed ? "passed" : "failed");
+    }
+
+    void report_batch(const char* name, std::vector<josephus_query>& queries) {
+        std::vector<uint32_t> survivors(queries.size());
+        auto start = chrono::steady_clock::now();
+        uint64_t checksum = 0;
+        for (const josephus_query& query : queries) {checksum += solution::josephus_survivor(query.n, query.k);}
+        double single = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+        JosephusBatch batch;
+        start = chrono::steady_clock::now();
+        batch.solve(queries.data(), queries.size(), survivors.data());
+        double cold = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+        start = chrono::steady_clock::now();
+        batch.solve(queries.data(), queries.size(), survivors.data());
+        double warm = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+        for (uint32_t survivor : survivors) {checksum -= survivor;}
+
+        printf("%-8s %-10zu %-16.3g %-16.3g %-16.3g%s\n", name, queries.size(), queries.size() / single,
+               queries.size() / cold, queries.size() / warm, checksum == 0 ? "" : " MISMATCH");
+    }
+
+    // Queries/second for a dense sweep (every n up to 20000 for k up to 64) and a sparse one
+    // (random n up to 10^9 and k up to 100), one at a time against the batch API cold and warm
+    void benchmark_batch() {
+        printf("\n%-8s %-10s %-16s %-16s %-16s\n", "sweep", "queries", "single (q/s)", "batch cold", "batch warm");
+        std::vector<josephus_query> dense;
+        for (uint32_t k = 1; k <= 64; k++) {
+            for (uint32_t n = 1; n <= 20000; n++) {dense.push_back({n, k});}
+        }
+        report_batch("dense", dense);
+
+        std::mt19937 rng(7);
+        std::vector<josephus_query> sparse(100000);
+        for (josephus_query& query : sparse) {query = {static_cast<uint32_t>(1 + rng() % 1000000000), static_cast<uint32_t>(1 + rng() % 100)};}
+        report_batch("sparse", sparse);
+    }
+}
+int main(int argc, char* argv[]) {
     solution::test_cases(1, 3, 42, 34);
     solution::test_cases(2, 1, 5, 5);
     solution::test_cases(3, 3, 15, 5);
+    solution::test_fast_solver(4);
+    solution::test_permutation(5);
+    test_batch(6);
     
     constexpr int n = 41;
     constexpr int k = 3;
     int survivor = solution::josephus_prob(n, k) + 1;
     printf("\nThe survivor is at position: %d", survivor);
+
+    // pass --bench [n] to compare the recursion with the fast solver, time the permutation of n people
+    // and measure batch query throughput
+    if (argc > 1 && std::string(argv[1]) == "--bench") {
+        solution::benchmark();
+        uint32_t people = argc > 2 ? static_cast<uint32_t>(std::stoul(argv[2])) : 10000000;
+        unsigned threads = std::max(1u, std::thread::hardware_concurrency());
+        solution::benchmark_permutation(people, 3, threads);
+        solution::benchmark_permutation(people, 1000, threads);
+        benchmark_batch();
+    }
 }
\ No newline at end of file